@@ -103,6 +103,15 @@ class MyExampleUsermod : public Usermod {
     }
 
 
+    /*
+     * getLoopInterval() tells the usermod manager how often loop() needs to be called (in ms).
+     * Return 0 (default) to be called on every main loop iteration. Usermods with an interval are skipped until
+     * they are due, and spread across main loop iterations, so polling slow sensors does not cause frame drops.
+     * Runtime statistics (min/avg/max in microseconds) of each usermod's loop() are shown in /json/info "um".
+     */
+    //uint16_t getLoopInterval() { return 1000; }
+
+
     /*
      * loop() is called continuously. Here you can check for events, read sensors, etc.
      * 
@@ -0,0 +1,137 @@
+#pragma once
+
+/*
+ * Built-in FFT engine for the audioreactive usermod
+ * enable with -D UM_AUDIOREACTIVE_USE_FAST_FFT (replaces arduinoFFT, no lib_deps needed)
+ *
+ * This is a real-input FFT, specialized for what the FFT task needs:
+ * - the N real samples are treated as N/2 complex values, so only a N/2 point complex FFT is needed (half the work of arduinoFFT)
+ * - twiddle factors, bit-reversal permutation and the "Flat Top" window are precomputed tables, so no sin()/cos() at runtime
+ * - magnitudes are computed directly during the final "split" pass, no separate complexToMagnitude() pass
+ * Results (magnitudes, major peak) are compatible with arduinoFFT "Flat Top" windowing + ComplexToMagnitude() + MajorPeak().
+ *
+ * RAM usage: 4*N bytes for twiddles, 2*N bytes for window, N/2 bytes for bit reversal (N=512: ~3.3kB)
+ */
+
+template <uint16_t N>
+class AudioFFT {
+  static_assert((N >= 16) && (N <= 512) && ((N & (N-1)) == 0), "AudioFFT: N must be a power of 2 between 16 and 512");
+
+  private:
+    static constexpr uint16_t M = N/2;  // size of the complex FFT
+    float *_vReal;                      // in: N real samples; out: magnitudes (bins 0 ... N/2, mirrored above N/2)
+    float *_vImag;                      // scratch buffer, at least N/2+1 floats
+    float  _samplingFrequency;
+    float  _cos[M];                     // cos(2*pi*k/N), k = 0 ... N/2-1
+    float  _sin[M];                     // sin(2*pi*k/N), k = 0 ... N/2-1
+    float  _window[M];                  // "Flat Top" window, first half (window is symmetrical)
+    uint8_t _bitrev[M];                 // bit-reversal permutation of M elements (M <= 256)
+
+  public:
+    AudioFFT(float *vReal, float *vImag, float samplingFrequency) :
+      _vReal(vReal),
+      _vImag(vImag),
+      _samplingFrequency(samplingFrequency)
+    {
+      for (unsigned k = 0; k < M; k++) {
+        _cos[k] = cosf(float(TWO_PI) * float(k) / float(N));
+        _sin[k] = sinf(float(TWO_PI) * float(k) / float(N));
+        // same coefficients as arduinoFFT FFT_WIN_TYP_FLT_TOP
+        float ratio = float(k) / float(N-1);
+        _window[k] = 0.2810639f - (0.5208972f * cosf(float(TWO_PI) * ratio)) + (0.1980399f * cosf(2.0f * float(TWO_PI) * ratio));
+        unsigned r = 0;
+        for (unsigned b = 1; b < M; b <<= 1) r = (r << 1) | ((k & b) ? 1 : 0);
+        _bitrev[k] = r;
+      }
+    }
+
+    // remove DC offset (mean value) from samples
+    void dcRemoval(void) {
+      float mean = 0.0f;
+      for (unsigned i = 0; i < N; i++) mean += _vReal[i];
+      mean /= float(N);
+      for (unsigned i = 0; i < N; i++) _vReal[i] -= mean;
+    }
+
+    // apply "Flat Top" window
+    void windowing(void) {
+      for (unsigned i = 0; i < M; i++) {
+        _vReal[i]       *= _window[i];
+        _vReal[N-1 - i] *= _window[i];
+      }
+    }
+
+    // compute FFT of real samples in vReal[], and replace them by magnitudes
+    void computeMagnitudes(void) {
+      // vReal[] interpreted as M complex values z[n] = x[2n] + i*x[2n+1] (interleaved re/im)
+      float *z = _vReal;
+
+      // bit-reversal permutation
+      for (unsigned k = 0; k < M; k++) {
+        unsigned r = _bitrev[k];
+        if (r > k) {
+          float tr = z[2*k], ti = z[2*k+1];
+          z[2*k]   = z[2*r]; z[2*k+1] = z[2*r+1];
+          z[2*r]   = tr;     z[2*r+1] = ti;
+        }
+      }
+
+      // iterative radix-2 complex FFT of size M. Twiddles for size M are every 2nd entry of the size N table.
+      for (unsigned len = 2, step = N/2; len <= M; len <<= 1, step >>= 1) {
+        const unsigned half = len >> 1;
+        for (unsigned i = 0; i < M; i += len) {
+          for (unsigned j = 0, t = 0; j < half; j++, t += step) {
+            const float wr =  _cos[t];
+            const float wi = -_sin[t];
+            float *a = &z[2*(i+j)];
+            float *b = &z[2*(i+j+half)];
+            const float br = b[0]*wr - b[1]*wi;
+            const float bi = b[0]*wi + b[1]*wr;
+            b[0] = a[0] - br; b[1] = a[1] - bi;
+            a[0] += br;       a[1] += bi;
+          }
+        }
+      }
+
+      // split pass: X[k] = (Z[k] + conj(Z[M-k]))/2 - i*W^k * (Z[k] - conj(Z[M-k]))/2, with W = exp(-2*pi*i/N)
+      // only magnitudes are needed, so write |X[k]| into the scratch buffer
+      _vImag[0] = fabsf(z[0] + z[1]);  // DC
+      _vImag[M] = fabsf(z[0] - z[1]);  // Nyquist
+      for (unsigned k = 1; k < M; k++) {
+        const float zr = z[2*k],     zi = z[2*k+1];
+        const float cr = z[2*(M-k)], ci = -z[2*(M-k)+1];   // conj(Z[M-k])
+        const float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);  // even part
+        const float orr = 0.5f * (zr - cr), oi = 0.5f * (zi - ci); // odd part (times i)
+        // -i * W^k = -i * (cos - i*sin) = -sin - i*cos
+        const float wr = -_sin[k], wi = -_cos[k];
+        const float xr = er + orr*wr - oi*wi;
+        const float xi = ei + orr*wi + oi*wr;
+        _vImag[k] = sqrtf(xr*xr + xi*xi);
+      }
+
+      // copy magnitudes back, mirror upper half like a full complex FFT would
+      for (unsigned k = 0; k <= M; k++) _vReal[k] = _vImag[k];
+      for (unsigned k = M+1; k < N; k++) _vReal[k] = _vReal[N-k];
+    }
+
+    // find strongest frequency (interpolated) and its magnitude - same method as arduinoFFT MajorPeak()
+    void majorPeak(float &frequency, float &value) {
+      float maxY = 0.0f;
+      unsigned indexOfMaxY = 0;
+      for (unsigned i = 1; i <= M; i++) {  // includes Nyquist bin like arduinoFFT, vReal[M+1] is its mirrored neighbour
+        if ((_vReal[i-1] < _vReal[i]) && (_vReal[i] > _vReal[i+1]) && (_vReal[i] > maxY)) {
+          maxY = _vReal[i];
+          indexOfMaxY = i;
+        }
+      }
+      if (indexOfMaxY == 0) { // no peak found
+        frequency = 0.0f;
+        value = 0.0f;
+        return;
+      }
+      const float a = _vReal[indexOfMaxY-1], b = _vReal[indexOfMaxY], c = _vReal[indexOfMaxY+1];
+      const float delta = 0.5f * ((a - c) / (a - 2.0f*b + c));
+      frequency = ((float(indexOfMaxY) + delta) * _samplingFrequency) / float(N-1);
+      value = fabsf(a - 2.0f*b + c);
+    }
+};
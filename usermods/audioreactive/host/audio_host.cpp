@@ -0,0 +1,291 @@
+/*
+ * Host harness for the audioreactive usermod audio processing (audio_dsp.h)
+ *
+ * Feeds a WAV file through the same code the FFT task and the usermod loop() run on the ESP32:
+ * band pass filter, FFT, GEQ channel mapping, post-processing, volume filters, AGC and peak detection.
+ * Time is simulated (FFT task runs once per batch of samples, loop() every 2ms), so results are repeatable.
+ *
+ *   audio_host [options] input.wav
+ *     --agc <0..3>          AGC preset (0 = off, default 1)
+ *     --gain <n>            sampleGain (default 60)
+ *     --squelch <n>         soundSquelch (default 10)
+ *     --bandpass            enable band pass filter
+ *     --golden <file>       compare GEQ channels against golden file, exit code 1 on mismatch
+ *     --tolerance <n>       allowed difference per GEQ channel for --golden (default 2)
+ *     --write-golden <file> write GEQ channels to golden file
+ *     --bench               measure processing time per batch
+ *     --repeat <n>          process the input n times (for --bench)
+ *   audio_host --gen <file.wav>  write the built-in test signal
+ *   audio_host --check-fft <file.wav>  compare the built-in FFT with a double precision reference of the arduinoFFT processing
+ *
+ * Without --golden/--write-golden/--bench, one line per batch is printed:
+ *   time(ms) volume majorPeak(Hz) magnitude samplePeak GEQ[0..15]
+ */
+
+#include "host_env.h"
+#include "../audio_dsp.h"
+#include "wav_source.h"
+
+#include <cstdio>
+#include <chrono>
+#include <vector>
+
+#ifdef UM_AUDIOREACTIVE_FFT_OVERLAP
+constexpr uint16_t samplesPerBatch = samplesFFT_2;
+#else
+constexpr uint16_t samplesPerBatch = samplesFFT;
+#endif
+
+//
+// test signal: silence, tones, sweep, beats and noise - 10 seconds, 16bit mono
+// integer noise generator and double precision math, so the file is the same on every PC
+//
+static bool writeTestSignal(const char *fileName)
+{
+  const uint32_t rate = SAMPLE_RATE;
+  const uint32_t numSamples = 10 * rate;
+  FILE *f = fopen(fileName, "wb");
+  if (!f) return false;
+
+  auto put16 = [f](uint16_t v) { fputc(v & 0xFF, f); fputc(v >> 8, f); };
+  auto put32 = [f](uint32_t v) { for (int i = 0; i < 4; i++) fputc((v >> (8*i)) & 0xFF, f); };
+  fwrite("RIFF", 1, 4, f); put32(36 + 2*numSamples); fwrite("WAVE", 1, 4, f);
+  fwrite("fmt ", 1, 4, f); put32(16); put16(1); put16(1); put32(rate); put32(2*rate); put16(2); put16(16);
+  fwrite("data", 1, 4, f); put32(2*numSamples);
+
+  uint32_t lcg = 12345;
+  auto noise = [&lcg]() { lcg = lcg * 1664525u + 1013904223u; return double(int32_t(lcg) >> 16) / 32768.0; }; // -1 ... 1
+  double phase = 0.0;
+  for (uint32_t n = 0; n < numSamples; n++) {
+    const double t = double(n) / rate;
+    double s = 0.0;
+    if (t < 1.0) {                      // near silence: noise gate must stay closed
+      s = 2.0 * noise();
+    } else if (t < 3.0) {               // steady tones in low, mid and high channels
+      s = 400.0 * (sin(TWO_PI * 100.0 * t) + sin(TWO_PI * 1000.0 * t) + sin(TWO_PI * 5000.0 * t));
+    } else if (t < 7.0) {               // logarithmic sweep 40Hz ... 10kHz, walks through all GEQ channels
+      const double f0 = 40.0, f1 = 10000.0, len = 4.0;
+      phase += TWO_PI * f0 * pow(f1 / f0, (t - 3.0) / len) / rate;
+      s = 800.0 * sin(phase);
+    } else if (t < 9.0) {               // beats: decaying 60Hz kick every 500ms, short noise burst in between
+      const double tb = fmod(t - 7.0, 0.5);
+      s = 1600.0 * exp(-tb * 12.0) * sin(TWO_PI * 60.0 * tb);
+      if (tb > 0.25 && tb < 0.3) s += 600.0 * noise();
+    } else {                            // loud noise, fading out
+      s = 1200.0 * (10.0 - t) * noise();
+    }
+    long v = lround(s);
+    put16(uint16_t(int16_t(constrain(v, -32768L, 32767L))));
+  }
+  fclose(f);
+  return true;
+}
+
+static bool readGolden(const char *fileName, std::vector<std::vector<int>> &golden)
+{
+  FILE *f = fopen(fileName, "r");
+  if (!f) return false;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    std::vector<int> geq(NUM_GEQ_CHANNELS);
+    char *p = line;
+    for (int i = 0; i < NUM_GEQ_CHANNELS; i++) geq[i] = strtol(p, &p, 10);
+    golden.push_back(geq);
+  }
+  fclose(f);
+  return true;
+}
+
+//
+// reference for the built-in FFT: same steps as arduinoFFT DCRemoval(), Windowing(FFT_WIN_TYP_FLT_TOP), Compute(),
+// ComplexToMagnitude() and MajorPeak(), but with a direct DFT in double precision
+//
+static void referenceFFT(const float *samples, double *mag, double &peakFreq, double &peakMag)
+{
+  const unsigned N = samplesFFT, M = N/2;
+  double x[samplesFFT];
+  double mean = 0.0;
+  for (unsigned i = 0; i < N; i++) mean += samples[i];
+  mean /= N;
+  for (unsigned i = 0; i < N; i++) x[i] = samples[i] - mean;
+  for (unsigned i = 0; i < M; i++) {
+    double ratio = double(i) / double(N-1);
+    double w = 0.2810639 - (0.5208972 * cos(TWO_PI * ratio)) + (0.1980399 * cos(2.0 * TWO_PI * ratio));
+    x[i] *= w;
+    x[N-1 - i] *= w;
+  }
+  for (unsigned k = 0; k <= M+1; k++) {
+    double re = 0.0, im = 0.0;
+    for (unsigned n = 0; n < N; n++) {
+      double a = TWO_PI * double((k * n) % N) / double(N);
+      re += x[n] * cos(a);
+      im -= x[n] * sin(a);
+    }
+    mag[k] = sqrt(re*re + im*im);
+  }
+  peakFreq = 0.0; peakMag = 0.0;
+  double maxY = 0.0;
+  unsigned idx = 0;
+  for (unsigned i = 1; i <= M; i++) {
+    if ((mag[i-1] < mag[i]) && (mag[i] > mag[i+1]) && (mag[i] > maxY)) { maxY = mag[i]; idx = i; }
+  }
+  if (idx == 0) return;
+  double delta = 0.5 * ((mag[idx-1] - mag[idx+1]) / (mag[idx-1] - 2.0*mag[idx] + mag[idx+1]));
+  peakFreq = ((idx + delta) * SAMPLE_RATE) / double(N-1);
+  peakMag = fabs(mag[idx-1] - 2.0*mag[idx] + mag[idx+1]);
+}
+
+static int checkFFT(const char *fileName)
+{
+  WAVSource source;
+  if (!source.initialize(fileName)) { fprintf(stderr, "cannot read %s (PCM WAV expected)\n", fileName); return 2; }
+  static float samples[samplesFFT], re[samplesFFT], scratch[samplesFFT];
+  static AudioFFT<samplesFFT> fft(re, scratch, SAMPLE_RATE);
+  double mag[samplesFFT_2+2];
+  double maxError = 0.0, maxPeakError = 0.0;
+  size_t batches = 0, peakMismatches = 0;
+
+  while (!source.endOfFile()) {
+    source.getSamples(samples, samplesFFT);
+    memcpy(re, samples, sizeof(re));
+    fft.dcRemoval();
+    fft.windowing();
+    fft.computeMagnitudes();
+    float peakFreq, peakMag;
+    fft.majorPeak(peakFreq, peakMag);
+
+    double refFreq, refMag;
+    referenceFFT(samples, mag, refFreq, refMag);
+    double maxMag = 0.0;
+    for (unsigned k = 0; k <= samplesFFT_2; k++) maxMag = MAX(maxMag, mag[k]);
+    if (maxMag < 1.0) continue; // silence, nothing to compare
+    batches++;
+    for (unsigned k = 0; k <= samplesFFT_2; k++) maxError = MAX(maxError, fabs(re[k] - mag[k]) / maxMag);
+    // only check the peak if it stands out, with noise there are several nearly equal candidates
+    if (refMag > 0.01 * maxMag) {
+      double e = fabs(peakFreq - refFreq);
+      if (e > 1.0) peakMismatches++;
+      else maxPeakError = MAX(maxPeakError, e);
+    }
+  }
+  printf("%zu batches: max. magnitude error %.2e (relative to largest bin), max. peak frequency error %.3f Hz, %zu peak mismatches\n",
+         batches, maxError, maxPeakError, peakMismatches);
+  return (maxError < 1e-4 && peakMismatches == 0) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+  const char *inputFile = nullptr;
+  const char *goldenFile = nullptr;
+  const char *writeGoldenFile = nullptr;
+  int tolerance = 2;
+  bool bench = false;
+  int repeat = 1;
+
+  soundAgc = 1;
+  for (int i = 1; i < argc; i++) {
+    const char *a = argv[i];
+    bool hasArg = i+1 < argc;
+    if      (!strcmp(a, "--gen") && hasArg)          return writeTestSignal(argv[++i]) ? 0 : 2;
+    else if (!strcmp(a, "--check-fft") && hasArg)    return checkFFT(argv[++i]);
+    else if (!strcmp(a, "--agc") && hasArg)          { int agc = atoi(argv[++i]); soundAgc = constrain(agc, 0, AGC_NUM_PRESETS); }
+    else if (!strcmp(a, "--gain") && hasArg)         sampleGain = atoi(argv[++i]);
+    else if (!strcmp(a, "--squelch") && hasArg)      soundSquelch = atoi(argv[++i]);
+    else if (!strcmp(a, "--bandpass"))               useBandPassFilter = true;
+    else if (!strcmp(a, "--golden") && hasArg)       goldenFile = argv[++i];
+    else if (!strcmp(a, "--tolerance") && hasArg)    tolerance = atoi(argv[++i]);
+    else if (!strcmp(a, "--write-golden") && hasArg) writeGoldenFile = argv[++i];
+    else if (!strcmp(a, "--bench"))                  bench = true;
+    else if (!strcmp(a, "--repeat") && hasArg)       { int n = atoi(argv[++i]); repeat = MAX(n, 1); }
+    else if (a[0] != '-' && !inputFile)              inputFile = a;
+    else {
+      fprintf(stderr, "usage: %s [--agc n] [--gain n] [--squelch n] [--bandpass] [--golden file [--tolerance n]] [--write-golden file] [--bench [--repeat n]] input.wav\n"
+                      "       %s --gen test_signal.wav\n"
+                      "       %s --check-fft input.wav\n", argv[0], argv[0], argv[0]);
+      return 2;
+    }
+  }
+  if (!inputFile) { fprintf(stderr, "no input file\n"); return 2; }
+
+  std::vector<std::vector<int>> golden;
+  if (goldenFile && !readGolden(goldenFile, golden)) { fprintf(stderr, "cannot read %s\n", goldenFile); return 2; }
+  FILE *out = nullptr;
+  if (writeGoldenFile) {
+    out = fopen(writeGoldenFile, "w");
+    if (!out) { fprintf(stderr, "cannot write %s\n", writeGoldenFile); return 2; }
+    fprintf(out, "# GEQ channels after each batch of %u samples, %s, agc %d, gain %d, squelch %d, bandpass %d\n",
+            samplesPerBatch, inputFile, soundAgc, sampleGain, soundSquelch, useBandPassFilter);
+  }
+
+  const double batchTime = 1000.0 * samplesPerBatch / SAMPLE_RATE;  // ms
+  double simTime = 0.0;     // ms, end of current batch
+  double loopTime = 0.0;    // ms, next loop() run
+  size_t batches = 0, fftBatches = 0, mismatches = 0;
+  int maxDiff = 0;
+  double totalUs = 0.0, fftUs = 0.0, minUs = 1e9, maxUs = 0.0;
+
+  for (int r = 0; r < repeat; r++) {
+    WAVSource source;
+    if (!source.initialize(inputFile)) { fprintf(stderr, "cannot read %s (PCM WAV expected)\n", inputFile); return 2; }
+    if (r == 0 && source.getSampleRate() != SAMPLE_RATE)
+      fprintf(stderr, "warning: %s has %u Hz sample rate, GEQ channels expect %u Hz\n", inputFile, source.getSampleRate(), (unsigned)SAMPLE_RATE);
+
+    while (!source.endOfFile()) {
+      // FFT task: a batch of samples is complete
+      simTime += batchTime;
+      hostMillis = (unsigned long)simTime;
+      getNewSamples(&source);
+      auto start = std::chrono::steady_clock::now();
+      bool haveDoneFFT = processAudioBlock();
+      double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+      totalUs += us;
+      if (haveDoneFFT) { fftUs += us; fftBatches++; minUs = MIN(minUs, us); maxUs = MAX(maxUs, us); }
+
+      // usermod loop(): volume filters and AGC every 2ms until the next batch is ready
+      for (; loopTime < simTime + batchTime; loopTime += 2.0) {
+        hostMillis = (unsigned long)loopTime;
+        getSample();
+        agcAvg(0);
+        fetchFFTResults();
+        autoResetPeak();
+      }
+
+      if (r == 0) {
+        if (out) {
+          for (int i = 0; i < NUM_GEQ_CHANNELS; i++) fprintf(out, "%s%d", i ? " " : "", fftResult[i]);
+          fprintf(out, "\n");
+        }
+        if (goldenFile && batches < golden.size()) {
+          bool diff = false;
+          for (int i = 0; i < NUM_GEQ_CHANNELS; i++) {
+            int d = abs(int(fftResult[i]) - golden[batches][i]);
+            maxDiff = MAX(maxDiff, d);
+            if (d > tolerance) diff = true;
+          }
+          if (diff && mismatches++ < 10) fprintf(stderr, "batch %zu (%.0f ms): GEQ differs from golden output\n", batches, simTime);
+        }
+        if (!out && !goldenFile && !bench) {
+          printf("%8.1f %6.1f %7.1f %9.1f %d ", simTime, soundAgc ? sampleAgc : sampleAvg, FFT_MajorPeak, FFT_Magnitude, samplePeak);
+          for (int i = 0; i < NUM_GEQ_CHANNELS; i++) printf(" %3d", fftResult[i]);
+          printf("\n");
+        }
+      }
+      batches++;
+    }
+  }
+
+  if (out) fclose(out);
+  if (bench) {
+    printf("%zu batches of %u samples, %zu with FFT\n", batches, samplesPerBatch, fftBatches);
+    printf("all batches:  %.1f us/batch average\n", totalUs / MAX(batches, (size_t)1));
+    if (fftBatches) printf("with FFT:     %.1f us/batch average, %.1f min, %.1f max\n", fftUs / fftBatches, minUs, maxUs);
+  }
+  if (goldenFile) {
+    size_t checked = batches / repeat;
+    if (checked != golden.size()) { fprintf(stderr, "golden output has %zu batches, input has %zu\n", golden.size(), checked); mismatches++; }
+    printf("%zu batches checked, %zu mismatches, max. difference %d (tolerance %d)\n", checked, mismatches, maxDiff, tolerance);
+    return mismatches ? 1 : 0;
+  }
+  return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+ * Minimal environment for building audio_dsp.h on a PC (Linux, macOS, MinGW)
+ * Provides what the DSP code takes from wled.h and audio_source.h, with a simulated millis() clock.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#define ARDUINO_ARCH_ESP32          // DSP code follows the ESP32 path (samples come from the FFT task)
+
+#ifndef UM_AUDIOREACTIVE_USE_FAST_FFT
+  #define UM_AUDIOREACTIVE_USE_FAST_FFT // arduinoFFT is an Arduino library, the built-in FFT builds anywhere
+#endif
+
+#define SRate_t uint32_t
+
+#ifndef TWO_PI
+  #define TWO_PI 6.283185307179586476925286766559
+#endif
+#ifndef MAX
+  #define MAX(a,b) ((a)>(b)?(a):(b))
+#endif
+#ifndef MIN
+  #define MIN(a,b) ((a)<(b)?(a):(b))
+#endif
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+// simulated time: advanced by the harness, so results do not depend on how fast the PC is
+static unsigned long hostMillis = 0;
+static inline unsigned long millis(void) { return hostMillis; }
+
+// the only thing audio_dsp.h needs from the strip
+struct HostStrip {
+  uint16_t getMinShowDelay(void) const { return 15; } // MIN_SHOW_DELAY at the default 42 FPS
+};
+static HostStrip strip;
@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+ * File backed audio source for the host harness
+ * Reads PCM WAV files (8, 16, 24 or 32 bit integer, mono or multi-channel - only the first channel is used)
+ * and delivers samples like I2SSource::getSamples() does: float, in 16bit range, multiplied by sampleScale.
+ * Reading past the end delivers silence.
+ */
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+class WAVSource {
+  public:
+    WAVSource(float sampleScale = 1.0f) :
+      _file(nullptr),
+      _sampleRate(0),
+      _channels(0),
+      _bytesPerSample(0),
+      _samplesLeft(0),
+      _sampleScale(sampleScale)
+    {}
+    ~WAVSource() { deinitialize(); }
+
+    bool initialize(const char *fileName) {
+      deinitialize();
+      _file = fopen(fileName, "rb");
+      if (!_file) return false;
+
+      uint8_t hdr[12];
+      if (fread(hdr, 1, 12, _file) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr+8, "WAVE", 4)) return fail();
+
+      bool haveFormat = false;
+      uint8_t chunk[8];
+      while (fread(chunk, 1, 8, _file) == 8) {
+        uint32_t len = le32(chunk+4);
+        if (!memcmp(chunk, "fmt ", 4)) {
+          uint8_t fmt[16];
+          if (len < 16 || fread(fmt, 1, 16, _file) != 16) return fail();
+          uint16_t format = le16(fmt);
+          _channels       = le16(fmt+2);
+          _sampleRate     = le32(fmt+4);
+          _bytesPerSample = le16(fmt+14) / 8;
+          // PCM, or WAVE_FORMAT_EXTENSIBLE (which is used for PCM with more than 16 bits)
+          if ((format != 1 && format != 0xFFFE) || _channels == 0 || _bytesPerSample < 1 || _bytesPerSample > 4) return fail();
+          haveFormat = true;
+          if (fseek(_file, (len - 16) + (len & 1), SEEK_CUR)) return fail();
+        } else if (!memcmp(chunk, "data", 4)) {
+          if (!haveFormat) return fail();
+          _samplesLeft = len / (_channels * _bytesPerSample);
+          return true;
+        } else if (fseek(_file, len + (len & 1), SEEK_CUR)) {
+          return fail();
+        }
+      }
+      return fail();
+    }
+
+    void deinitialize(void) {
+      if (_file) fclose(_file);
+      _file = nullptr;
+      _samplesLeft = 0;
+    }
+
+    void getSamples(float *buffer, uint16_t num_samples) {
+      uint8_t frame[4*8];
+      const unsigned frameSize = _channels * _bytesPerSample;
+      for (unsigned i = 0; i < num_samples; i++) {
+        float sample = 0.0f;
+        if (_samplesLeft > 0 && frameSize <= sizeof(frame) && fread(frame, 1, frameSize, _file) == frameSize) {
+          _samplesLeft--;
+          switch (_bytesPerSample) {
+            case 1: sample = float((int32_t(frame[0]) - 128) << 8); break;              // 8bit WAV is unsigned
+            case 2: sample = float(int16_t(le16(frame))); break;
+            case 3: sample = float(int32_t(le32(frame) << 8)) / 65536.0f; break;        // 24bit and 32bit: keep lower bits as decimal places (like I2S)
+            case 4: sample = float(int32_t(le32(frame))) / 65536.0f; break;
+          }
+        } else {
+          _samplesLeft = 0;
+        }
+        buffer[i] = sample * _sampleScale;
+      }
+    }
+
+    bool     isInitialized(void) const { return _file != nullptr; }
+    bool     endOfFile(void)     const { return _samplesLeft == 0; }
+    uint32_t getSampleRate(void) const { return _sampleRate; }
+    uint32_t samplesLeft(void)   const { return _samplesLeft; }
+
+  private:
+    FILE    *_file;
+    uint32_t _sampleRate;
+    uint16_t _channels;
+    uint16_t _bytesPerSample;
+    uint32_t _samplesLeft;
+    float    _sampleScale;
+
+    bool fail(void) { deinitialize(); return false; }
+    static uint16_t le16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+    static uint32_t le32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24); }
+};
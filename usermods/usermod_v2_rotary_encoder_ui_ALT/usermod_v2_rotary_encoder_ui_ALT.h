@@ -398,10 +398,10 @@ void RotaryEncoderUIUsermod::sortModesAndPalettes() {
   modes_alpha_indexes = re_initIndexArray(strip.getModeCount());
   re_sortModes(modes_qstrings, modes_alpha_indexes, strip.getModeCount(), MODE_SORT_SKIP_COUNT);
 
-  palettes_qstrings = re_findModeStrings(JSON_palette_names, strip.getPaletteCount()+strip.customPalettes.size());
-  palettes_alpha_indexes = re_initIndexArray(strip.getPaletteCount()+strip.customPalettes.size());
-  if (strip.customPalettes.size()) {
-    for (int i=0; i<strip.customPalettes.size(); i++) {
+  palettes_qstrings = re_findModeStrings(JSON_palette_names, strip.getPaletteCount()+strip.getCustomPaletteCount());
+  palettes_alpha_indexes = re_initIndexArray(strip.getPaletteCount()+strip.getCustomPaletteCount());
+  if (strip.getCustomPaletteCount()) {
+    for (int i=0; i<strip.getCustomPaletteCount(); i++) {
       palettes_alpha_indexes[strip.getPaletteCount()+i] = 255-i;
       palettes_qstrings[strip.getPaletteCount()+i] = PSTR("~Custom~");
     }
@@ -700,7 +700,7 @@ void RotaryEncoderUIUsermod::findCurrentEffectAndPalette() {
 
   effectPaletteIndex = 0;
   DEBUG_PRINTLN(effectPalette);
-  for (uint8_t i = 0; i < strip.getPaletteCount()+strip.customPalettes.size(); i++) {
+  for (uint8_t i = 0; i < strip.getPaletteCount()+strip.getCustomPaletteCount(); i++) {
     if (palettes_alpha_indexes[i] == effectPalette) {
       effectPaletteIndex = i;
       DEBUG_PRINTLN(F("Found palette."));
@@ -890,7 +890,7 @@ void RotaryEncoderUIUsermod::changePalette(bool increase) {
   }
   display->updateRedrawTime();
 #endif
-  effectPaletteIndex = max(min((unsigned)(increase ? effectPaletteIndex+1 : effectPaletteIndex-1), strip.getPaletteCount()+strip.customPalettes.size()-1), 0U);
+  effectPaletteIndex = max(min((unsigned)(increase ? effectPaletteIndex+1 : effectPaletteIndex-1), strip.getPaletteCount()+strip.getCustomPaletteCount()-1), 0U);
   effectPalette = palettes_alpha_indexes[effectPaletteIndex];
   stateChanged = true;
   if (applyToAll) {
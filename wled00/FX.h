@@ -83,6 +83,37 @@
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
 
+/* Highest effect slowdown: effect using more than its share of the CPU (run time against its update period, divided by
+  number of active segments) is updated at half, quarter, ... down to 1/2^WLED_MAX_FX_SLOWDOWN of its normal rate. */
+#ifndef WLED_MAX_FX_SLOWDOWN
+  #define WLED_MAX_FX_SLOWDOWN 3
+#endif
+
+/* color_from_palette() uses a 256 entry pre-interpolated copy of the segment palette (768 bytes of SRAM).
+  ESP8266 only caches the 16 entry palette to save RAM. */
+#if !defined(ESP8266) && !defined(WLED_DISABLE_PALETTE_LUT)
+  #define WLED_USE_PALETTE_LUT
+#endif
+
+/* Effects of segments that do not share any LEDs are rendered on both cores of a dual core ESP32 (opt-in).
+  Each core has its own render context (SEGLEN, SEGCOLOR, SEGPALETTE and palette cache), the loop task waits for
+  the FX task before show(). */
+#if defined(WLED_ENABLE_PARALLEL_FX) && defined(ARDUINO_ARCH_ESP32) && !defined(CONFIG_FREERTOS_UNICORE)
+  #define WLED_PARALLEL_FX
+  #define WLED_RENDER_CONTEXTS 2
+  #ifndef WLED_FX_TASK_STACK
+    #define WLED_FX_TASK_STACK 8192
+  #endif
+  // guards state shared by effects running on both cores (effect data accounting, deadline statistics)
+  extern portMUX_TYPE fxMux;
+  #define FX_ENTER_CRITICAL() portENTER_CRITICAL(&fxMux)
+  #define FX_EXIT_CRITICAL()  portEXIT_CRITICAL(&fxMux)
+#else
+  #define WLED_RENDER_CONTEXTS 1
+  #define FX_ENTER_CRITICAL()
+  #define FX_EXIT_CRITICAL()
+#endif
+
 #define MIN_SHOW_DELAY   (_frametime < 16 ? 8 : 15)
 
 #define NUM_COLORS       3 /* number of colors per segment */
@@ -91,8 +122,8 @@
 //#define SEGCOLOR(x)      strip._segments[strip.getCurrSegmentId()].currentColor(x, strip._segments[strip.getCurrSegmentId()].colors[x])
 //#define SEGLEN           strip._segments[strip.getCurrSegmentId()].virtualLength()
 #define SEGCOLOR(x)      strip.segColor(x) /* saves us a few kbytes of code */
-#define SEGPALETTE       strip._currentPalette
-#define SEGLEN           strip._virtualSegmentLength /* saves us a few kbytes of code */
+#define SEGPALETTE       strip.renderContext().palette
+#define SEGLEN           strip.renderContext().virtualLength /* saves us a few kbytes of code */
 #define SPEED_FORMULA_L  (5U + (50U*(255U - SEGMENT.speed))/SEGLEN)
 
 // some common colors
@@ -373,6 +404,9 @@ typedef struct Segment {
     uint16_t aux0;  // custom var
     uint16_t aux1;  // custom var
     byte     *data; // effect data pointer
+    uint16_t fxTime;   // effect run time in us (moving average)
+    uint8_t  slowdown; // effect update rate is divided by 2^slowdown while it exceeds its CPU budget
+    bool     outOfMem; // effect data allocation was refused (segment quota or RAM depleted)
     static uint16_t maxWidth, maxHeight;  // these define matrix width & height (max. segment dimensions)
 
     typedef struct TemporarySegmentData {
@@ -474,6 +508,9 @@ typedef struct Segment {
       aux0(0),
       aux1(0),
       data(nullptr),
+      fxTime(0),
+      slowdown(0),
+      outOfMem(false),
       _capabilities(0),
       _dataLen(0),
       _t(nullptr)
@@ -521,6 +558,7 @@ typedef struct Segment {
     inline uint16_t width(void)          const { return isActive() ? (stop - start) : 0; }  // segment width in physical pixels (length if 1D)
     inline uint16_t height(void)         const { return stopY - startY; }                   // segment height (if 2D) in physical pixels (it *is* always >=1)
     inline uint16_t length(void)         const { return width() * height(); }               // segment length (count) in physical pixels
+    inline bool     overlaps(const Segment &s) const { return start < s.stop && s.start < stop && startY < s.stopY && s.startY < stopY; } // shares physical pixels
     inline uint16_t groupLength(void)    const { return grouping + spacing; }
     inline uint8_t  getLightCapabilities(void) const { return _capabilities; }
 
@@ -538,7 +576,9 @@ typedef struct Segment {
     void    setOption(uint8_t n, bool val);
     void    setMode(uint8_t fx, bool loadDefaults = false);
     void    setPalette(uint8_t pal);
-    uint8_t differs(Segment& b) const;
+    void    saveState(byte *state) const;                        // state must hold SEG_STATE_SIZE bytes
+    uint8_t differs(const byte *state) const;                    // returns SEG_DIFFERS_* bits
+    void    applyState(const byte *state, uint8_t what = SEG_DIFFERS_ALL); // applies SEG_DIFFERS_* parts of state
     void    refreshLightCapabilities(void);
 
     // runtime data functions
@@ -552,7 +592,7 @@ typedef struct Segment {
       * Call resetIfRequired before calling the next effect function.
       * Safe to call from interrupts and network requests.
       */
-    inline void markForReset(void) { reset = true; }  // setOption(SEG_OPTION_RESET, true)
+    void markForReset(void);  // setOption(SEG_OPTION_RESET, true), also wakes the frame scheduler
 
     // transition functions
     void     startTransition(uint16_t dur); // transition has to start before actual segment values change
@@ -566,7 +606,7 @@ typedef struct Segment {
     uint8_t  currentBri(bool useCct = false);
     uint8_t  currentMode(void);
     uint32_t currentColor(uint8_t slot);
-    CRGBPalette16 &loadPalette(CRGBPalette16 &tgt, uint8_t pal);
+    CRGBPalette16 &loadPalette(CRGBPalette16 &tgt, uint8_t pal, bool useCache = true);
     CRGBPalette16 &currentPalette(CRGBPalette16 &tgt, uint8_t paletteID);
 
     // 1D strip
@@ -664,6 +704,33 @@ typedef struct Segment {
 } segment;
 //static int segSize = sizeof(Segment);
 
+// state of the segment being serviced, effect functions access it through SEG* macros
+typedef struct RenderContext {
+  CRGBPalette16 palette;          // palette used for current effect (includes transition)
+  uint32_t      colors[NUM_COLORS]; // colors used for current effect (includes transition)
+  uint16_t      virtualLength;
+  uint8_t       segId;            // index of the segment being serviced
+  // palette cache for color_from_palette(), only refreshed if palette content changes
+  CRGBPalette16 paletteCache;
+  uint8_t       paletteCacheBlend;  // TBlendType the cache was built with
+  #ifdef WLED_USE_PALETTE_LUT
+  CRGB          paletteLUT[256];    // pre-interpolated palette, filled on demand
+  uint32_t      paletteLUTValid[8]; // bit set if paletteLUT entry is valid
+  #endif
+  RenderContext()
+    : palette(CRGBPalette16(CRGB::Black))
+    , colors{0,0,0}
+    , virtualLength(0)
+    , segId(0)
+    , paletteCache(CRGBPalette16(CRGB::Black))
+    , paletteCacheBlend(LINEARBLEND)
+  {
+    #ifdef WLED_USE_PALETTE_LUT
+    memset(paletteLUTValid, 0, sizeof(paletteLUTValid));
+    #endif
+  }
+} render_ctx_t;
+
 // main "strip" class
 class WS2812FX {  // 96 bytes
   typedef uint16_t (*mode_ptr)(void); // pointer to mode function
@@ -692,10 +759,6 @@ class WS2812FX {  // 96 bytes
 #ifndef WLED_DISABLE_2D
       panels(1),
 #endif
-      // semi-private (just obscured) used in effect functions through macros
-      _currentPalette(CRGBPalette16(CRGB::Black)),
-      _colors_t{0,0,0},
-      _virtualSegmentLength(0),
       // true private variables
       _length(DEFAULT_LED_COUNT),
       _brightness(DEFAULT_BRIGHTNESS),
@@ -703,6 +766,9 @@ class WS2812FX {  // 96 bytes
       _targetFps(WLED_FPS),
       _frametime(FRAMETIME_FIXED),
       _cumulativeFps(2),
+      _missedDeadlines(0),
+      _avgLateness(0),
+      _fxShares(0),
       _isServicing(false),
       _isOffRefreshRequired(false),
       _hasWhiteChannel(false),
@@ -712,7 +778,7 @@ class WS2812FX {  // 96 bytes
       customMappingTable(nullptr),
       customMappingSize(0),
       _lastShow(0),
-      _segment_index(0),
+      _nextFrame(0),
       _mainSegment(0),
       _queuedChangesSegId(255),
       _qStart(0),
@@ -721,9 +787,19 @@ class WS2812FX {  // 96 bytes
       _qStopY(0),
       _qGrouping(0),
       _qSpacing(0),
-      _qOffset(0)
+      _qOffset(0),
+      _customPaletteCount(0),
+      _customPaletteUse(0),
+      _customPaletteGen(0),
+      _customPaletteCacheGen(0)
     {
       WS2812FX::instance = this;
+      for (auto &c : _customPaletteCache) c.index = 255;
+      #ifdef WLED_PARALLEL_FX
+      _fxTask = nullptr;
+      _loopCore = 1; // APP CPU, confirmed when FX task is started in finalizeInit()
+      _render[1].segId = 255;
+      #endif
       _mode.reserve(_modeCount);     // allocate memory to prevent initial fragmentation (does not increase size())
       _modeData.reserve(_modeCount); // allocate memory to prevent initial fragmentation (does not increase size())
       if (_mode.capacity() <= 1 || _modeData.capacity() <= 1) _modeCount = 1; // memory allocation failed only show Solid
@@ -738,7 +814,6 @@ class WS2812FX {  // 96 bytes
 #ifndef WLED_DISABLE_2D
       panel.clear();
 #endif
-      customPalettes.clear();
     }
 
     static WS2812FX* getInstance(void) { return instance; }
@@ -777,7 +852,7 @@ class WS2812FX {  // 96 bytes
     inline void trigger(void) { _triggered = true; } // Forces the next frame to be computed on all active segments.
     inline void setShowCallback(show_callback cb) { _callback = cb; }
     inline void setTransition(uint16_t t) { _transitionDur = t; }
-    inline void appendSegment(const Segment &seg = Segment()) { if (_segments.size() < getMaxSegments()) _segments.push_back(seg); }
+    inline void appendSegment(const Segment &seg = Segment()) { if (_segments.size() < getMaxSegments()) { _segments.push_back(seg); trigger(); } }
 
     bool
       checkSegmentAlignment(void),
@@ -788,6 +863,11 @@ class WS2812FX {  // 96 bytes
       deserializeMap(uint8_t n=0);
 
     inline bool isServicing(void) { return _isServicing; }
+    inline bool isServicingSegment(uint8_t id) { // true if the effect of segment id may be running
+      if (!_isServicing) return false;
+      for (unsigned i = 0; i < WLED_RENDER_CONTEXTS; i++) if (_render[i].segId == id) return true;
+      return false;
+    }
     inline bool hasWhiteChannel(void) {return _hasWhiteChannel;}
     inline bool isOffRefreshRequired(void) {return _isOffRefreshRequired;}
 
@@ -805,9 +885,10 @@ class WS2812FX {  // 96 bytes
     inline uint8_t getBrightness(void) { return _brightness; }
     inline uint8_t getMaxSegments(void) { return MAX_NUM_SEGMENTS; }  // returns maximum number of supported segments (fixed value)
     inline uint8_t getSegmentsNum(void) { return _segments.size(); }  // returns currently present segments
-    inline uint8_t getCurrSegmentId(void) { return _segment_index; }
+    inline uint8_t getCurrSegmentId(void) { return renderContext().segId; }
     inline uint8_t getMainSegmentId(void) { return _mainSegment; }
     inline uint8_t getPaletteCount() { return 13 + GRADIENT_PALETTE_COUNT; }  // will only return built-in palette count
+    inline uint8_t getCustomPaletteCount() { return _customPaletteCount; }
     inline uint8_t getTargetFps() { return _targetFps; }
     inline uint8_t getModeCount() { return _modeCount; }
 
@@ -829,7 +910,9 @@ class WS2812FX {  // 96 bytes
       getPixelColor(uint16_t);
 
     inline uint32_t getLastShow(void) { return _lastShow; }
-    inline uint32_t segColor(uint8_t i) { return _colors_t[i]; }
+    inline uint32_t getMissedDeadlines(void) { return _missedDeadlines; }
+    inline uint16_t getAvgLateness(void) { return _avgLateness; }
+    inline uint32_t segColor(uint8_t i) { return renderContext().colors[i]; }
 
     const char *
       getModeData(uint8_t id = 0) { return (id && id<_modeCount) ? _modeData[id] : PSTR("Solid"); }
@@ -887,14 +970,19 @@ class WS2812FX {  // 96 bytes
 
   // end 2D support
 
-    void loadCustomPalettes(void); // loads custom palettes from JSON
-    CRGBPalette16 _currentPalette; // palette used for current effect (includes transition)
-    std::vector<CRGBPalette16> customPalettes; // TODO: move custom palettes out of WS2812FX class
+    void loadCustomPalettes(bool compile = true); // (re)compiles custom palettes from JSON into palette bank
+    bool loadCustomPalette(uint8_t index, CRGBPalette16 &targetPalette, bool useCache = true); // loads custom palette from palette bank (or RAM cache, loop task only)
+    inline void invalidateCustomPaletteCache() { _customPaletteGen++; } // e.g. gamma changed, safe to call from any task
+    CRGB colorFromSegmentPalette(uint8_t index, uint8_t pbri); // uses palette cache of the segment being serviced
 
     // using public variables to reduce code size increase due to inline function getSegment() (with bounds checking)
     // and color transitions
-    uint32_t _colors_t[3]; // color used for effect (includes transition)
-    uint16_t _virtualSegmentLength;
+    render_ctx_t _render[WLED_RENDER_CONTEXTS];
+    #ifdef WLED_PARALLEL_FX
+    inline render_ctx_t& renderContext(void) { return _render[xPortGetCoreID() != _loopCore]; } // FX task uses second context
+    #else
+    inline render_ctx_t& renderContext(void) { return _render[0]; }
+    #endif
 
     std::vector<segment> _segments;
     friend class Segment;
@@ -907,6 +995,9 @@ class WS2812FX {  // 96 bytes
     uint8_t  _targetFps;
     uint16_t _frametime;
     uint16_t _cumulativeFps;
+    uint32_t _missedDeadlines; // effect frames rendered a whole frame period late (since boot)
+    uint16_t _avgLateness;     // ms, moving average of missed deadlines
+    uint8_t  _fxShares;        // CPU is shared between this many segments in the current frame, 0: no budget
 
     // will require only 1 byte
     struct {
@@ -926,18 +1017,45 @@ class WS2812FX {  // 96 bytes
     uint16_t  customMappingSize;
 
     unsigned long _lastShow;
+    unsigned long _nextFrame; // earliest segment deadline, service() sleeps until then unless triggered
 
-    uint8_t _segment_index;
     uint8_t _mainSegment;
     uint8_t _queuedChangesSegId;
     uint16_t _qStart, _qStop, _qStartY, _qStopY;
     uint8_t _qGrouping, _qSpacing;
     uint16_t _qOffset;
 
+    // custom palettes: count of palettes in palette bank and a small cache of most recently used ones
+    uint8_t _customPaletteCount;
+    struct {
+      CRGBPalette16 palette;
+      uint8_t       index;    // custom palette index (255: empty)
+      uint8_t       lastUse;  // LRU counter
+    } _customPaletteCache[WLED_CUSTOM_PALETTE_CACHE];
+    uint8_t _customPaletteUse;
+    uint8_t _customPaletteGen;      // incremented to invalidate the cache
+    uint8_t _customPaletteCacheGen; // generation the cache content belongs to
+
+    #ifdef WLED_PARALLEL_FX
+    TaskHandle_t      _fxTask;
+    SemaphoreHandle_t _fxStart, _fxDone;
+    uint8_t           _loopCore;
+    uint8_t           _fxTaskSegs[MAX_NUM_SEGMENTS]; // segments rendered by FX task in current frame
+    uint8_t           _fxTaskSegCount;
+    unsigned long     _fxTaskNow;
+    static void fxTask(void *parameter);
+    void renderParallel(unsigned long nowUp, const uint8_t *due, unsigned numDue);
+    #endif
+
     uint8_t
       estimateCurrentAndLimitBri(void);
 
+    bool
+      scheduleFrame(unsigned long nowUp, uint8_t *due, unsigned &numDue);
+
     void
+      renderSegment(Segment &seg, unsigned long nowUp, bool setCCT = true),
+      updatePaletteCache(void),
       setUpSegmentFromQueuedChanges(void);
 };
 
@@ -151,16 +151,39 @@ bool Segment::allocateData(size_t len) {
   //DEBUG_PRINTF("--   Allocating data (%d): %p\n", len, this);
   deallocateData();
   if (len == 0) return false; // nothing to do
-  if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) {
+  // segment quota: more than the fair share is only granted if every other active segment that still
+  // has to ask for data (effect not run yet) or was refused can get its fair share afterwards
+  // effects may allocate on both cores (WLED_PARALLEL_FX), so accounting is done in a critical section
+  // and effect RAM is claimed before malloc() (which must not run inside of it)
+  size_t reserve = 0;
+  FX_ENTER_CRITICAL();
+  if (len > FAIR_DATA_PER_SEG) {
+    for (size_t i = 0; i < strip.getSegmentsNum(); i++) {
+      const Segment &seg = strip.getSegment(i);
+      if (&seg != this && seg.isActive() && !seg.data && (seg.call == 0 || seg.outOfMem)) reserve += FAIR_DATA_PER_SEG;
+    }
+  }
+  bool fits = Segment::getUsedSegmentData() + len + reserve <= MAX_SEGMENT_DATA;
+  if (fits) Segment::addUsedSegmentData(len);
+  FX_EXIT_CRITICAL();
+  if (!fits) {
     // not enough memory
     DEBUG_PRINT(F("!!! Effect RAM depleted: "));
-    DEBUG_PRINTF("%d/%d !!!\n", len, Segment::getUsedSegmentData());
+    DEBUG_PRINTF("%d/%d (%d reserved) !!!\n", len, Segment::getUsedSegmentData(), reserve);
+    outOfMem = true;
     return false;
   }
   // do not use SPI RAM on ESP32 since it is slow
   data = (byte*) malloc(len);
-  if (!data) { DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); return false; } //allocation failed
-  Segment::addUsedSegmentData(len);
+  if (!data) { //allocation failed
+    FX_ENTER_CRITICAL();
+    Segment::addUsedSegmentData(-(int)len);
+    FX_EXIT_CRITICAL();
+    DEBUG_PRINTLN(F("!!! Allocation failed. !!!"));
+    outOfMem = true;
+    return false;
+  }
+  outOfMem = false;
   //DEBUG_PRINTF("---  Allocated data (%p): %d/%d -> %p\n", this, len, Segment::getUsedSegmentData(), data);
   _dataLen = len;
   memset(data, 0, len);
@@ -180,7 +203,9 @@ void Segment::deallocateData() {
     DEBUG_PRINTLN(F(", cowardly refusing to free nothing."));
   }
   data = nullptr;
+  FX_ENTER_CRITICAL();
   Segment::addUsedSegmentData(_dataLen <= Segment::getUsedSegmentData() ? -_dataLen : -Segment::getUsedSegmentData());
+  FX_EXIT_CRITICAL();
   _dataLen = 0;
 }
 
@@ -196,12 +221,13 @@ void Segment::resetIfRequired() {
   //DEBUG_PRINTF("-- Segment reset: %p\n", this);
   deallocateData();
   next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0;
+  fxTime = 0; slowdown = 0; outOfMem = false;
   reset = false;
 }
 
-CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
-  if (pal < 245 && pal > GRADIENT_PALETTE_COUNT+13) pal = 0;
-  if (pal > 245 && (strip.customPalettes.size() == 0 || 255U-pal > strip.customPalettes.size()-1)) pal = 0;
+// useCache: custom palettes may come from the RAM cache (loop task only, see WS2812FX::loadCustomPalette())
+CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal, bool useCache) {
+  if (pal >= strip.getPaletteCount() && 255U-pal >= strip.getCustomPaletteCount()) pal = 0; // neither built-in nor custom palette
   //default palette. Differs depending on effect
   if (pal == 0) switch (mode) {
     case FX_MODE_FIRE_2012  : pal = 35; break; // heat palette
@@ -219,20 +245,8 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
   switch (pal) {
     case 0: //default palette. Exceptions for specific effects above
       targetPalette = PartyColors_p; break;
-    case 1: {//periodically replace palette with a random one
-      unsigned long timeSinceLastChange = millis() - _lastPaletteChange;
-      if (timeSinceLastChange > randomPaletteChangeTime * 1000U) {
-        _randomPalette = _newRandomPalette;
-        _newRandomPalette = CRGBPalette16(
-                        CHSV(random8(), random8(160, 255), random8(128, 255)),
-                        CHSV(random8(), random8(160, 255), random8(128, 255)),
-                        CHSV(random8(), random8(160, 255), random8(128, 255)),
-                        CHSV(random8(), random8(160, 255), random8(128, 255)));
-        _lastPaletteChange = millis();
-        handleRandomPalette(); // do a 1st pass of blend
-      }
-      targetPalette = _randomPalette;
-      break;}
+    case 1: //periodically replaced by handleRandomPalette()
+      targetPalette = _randomPalette; break;
     case 2: {//primary color only
       CRGB prim = gamma32(colors[0]);
       targetPalette = CRGBPalette16(prim); break;}
@@ -270,8 +284,8 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
     case 12: //Rainbow stripe colors
       targetPalette = RainbowStripeColors_p; break;
     default: //progmem palettes
-      if (pal>245) {
-        targetPalette = strip.customPalettes[255-pal]; // we checked bounds above
+      if (pal >= strip.getPaletteCount()) {
+        if (!strip.loadCustomPalette(255-pal, targetPalette, useCache)) targetPalette = PartyColors_p; // we checked bounds above, palette bank not readable
       } else {
         byte tcp[72];
         memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[pal-13])), 72);
@@ -294,7 +308,7 @@ void Segment::startTransition(uint16_t dur) {
   if (!_t) return; // failed to allocate data
 
   //DEBUG_PRINTF("-- Started transition: %p\n", this);
-  loadPalette(_t->_palT, palette);
+  loadPalette(_t->_palT, palette, false); // also called from the async web task (deserializeSegment()), bypass palette cache
   _t->_briT           = on ? opacity : 0;
   _t->_cctT           = cct;
 #ifndef WLED_DISABLE_MODE_BLEND
@@ -463,12 +477,29 @@ CRGBPalette16 &Segment::currentPalette(CRGBPalette16 &targetPalette, uint8_t pal
 }
 
 // relies on WS2812FX::service() to call it max every 8ms or more (MIN_SHOW_DELAY)
+// only called from loop task, loadPalette() just reads _randomPalette (FX task, web server)
 void Segment::handleRandomPalette() {
+  // periodically replace palette with a random one
+  if (millis() - _lastPaletteChange > randomPaletteChangeTime * 1000U) {
+    _randomPalette = _newRandomPalette;
+    _newRandomPalette = CRGBPalette16(
+                    CHSV(random8(), random8(160, 255), random8(128, 255)),
+                    CHSV(random8(), random8(160, 255), random8(128, 255)),
+                    CHSV(random8(), random8(160, 255), random8(128, 255)),
+                    CHSV(random8(), random8(160, 255), random8(128, 255)));
+    _lastPaletteChange = millis();
+  }
   // just do a blend; if the palettes are identical it will just compare 48 bytes (same as _randomPalette == _newRandomPalette)
   // this will slowly blend _newRandomPalette into _randomPalette every 15ms or 8ms (depending on MIN_SHOW_DELAY)
   nblendPaletteTowardPalette(_randomPalette, _newRandomPalette, 48);
 }
 
+// flag only, the segment is reset by the loop task; wake the frame scheduler so it happens without waiting for next_time
+void Segment::markForReset() {
+  reset = true;
+  strip.trigger();
+}
+
 // segId is given when called from network callback, changes are queued if that segment is currently in its effect function
 void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t ofs, uint16_t i1Y, uint16_t i2Y, uint8_t segId) {
   // return if neither bounds nor grouping have changed
@@ -596,8 +627,7 @@ void Segment::setMode(uint8_t fx, bool loadDefaults) {
 }
 
 void Segment::setPalette(uint8_t pal) {
-  if (pal < 245 && pal > GRADIENT_PALETTE_COUNT+13) pal = 0; // built in palettes
-  if (pal > 245 && (strip.customPalettes.size() == 0 || 255U-pal > strip.customPalettes.size()-1)) pal = 0; // custom palettes
+  if (pal >= strip.getPaletteCount() && 255U-pal >= strip.getCustomPaletteCount()) pal = 0; // neither built-in nor custom palette
   if (pal != palette) {
     if (strip.paletteFade) startTransition(strip.getTransition());
     palette = pal;
@@ -846,33 +876,98 @@ uint32_t Segment::getPixelColor(int i)
   return strip.getPixelColor(i);
 }
 
-uint8_t Segment::differs(Segment& b) const {
+/*
+ * Compact segment state, fixed layout of SEG_STATE_SIZE bytes (same as the segment record of UDP sync packets):
+ *  0: SEG_STATE_VERSION (segment index in UDP packets), 1-4: start, stop, 5: grouping, 6: spacing, 7-8: offset,
+ *  9: options (LSB), 10: opacity, 11: mode, 12: speed, 13: intensity, 14: palette, 15-26: colors (RGBW),
+ *  27: cct, 28: options (MSB), 29: custom1, 30: custom2, 31: custom3 | check1-3 << 5, 32-35: startY, stopY
+ * 16 bit values are big endian. Segment name and runtime data are not part of the state.
+ */
+void Segment::saveState(byte *s) const {
+  s[0]  = SEG_STATE_VERSION;
+  s[1]  = start >> 8;
+  s[2]  = start & 0xFF;
+  s[3]  = stop >> 8;
+  s[4]  = stop & 0xFF;
+  s[5]  = grouping;
+  s[6]  = spacing;
+  s[7]  = offset >> 8;
+  s[8]  = offset & 0xFF;
+  s[9]  = options & 0xFF;
+  s[10] = opacity;
+  s[11] = mode;
+  s[12] = speed;
+  s[13] = intensity;
+  s[14] = palette;
+  for (unsigned i = 0; i < NUM_COLORS; i++) {
+    s[15+4*i] = R(colors[i]);
+    s[16+4*i] = G(colors[i]);
+    s[17+4*i] = B(colors[i]);
+    s[18+4*i] = W(colors[i]);
+  }
+  s[27] = cct;
+  s[28] = options >> 8;
+  s[29] = custom1;
+  s[30] = custom2;
+  s[31] = custom3 | (check1<<5) | (check2<<6) | (check3<<7);
+  s[32] = startY >> 8;
+  s[33] = startY & 0xFF;
+  s[34] = stopY >> 8;
+  s[35] = stopY & 0xFF;
+}
+
+uint8_t Segment::differs(const byte *s) const {
+  byte c[SEG_STATE_SIZE];
+  saveState(c);
   uint8_t d = 0;
-  if (start != b.start)         d |= SEG_DIFFERS_BOUNDS;
-  if (stop != b.stop)           d |= SEG_DIFFERS_BOUNDS;
-  if (offset != b.offset)       d |= SEG_DIFFERS_GSO;
-  if (grouping != b.grouping)   d |= SEG_DIFFERS_GSO;
-  if (spacing != b.spacing)     d |= SEG_DIFFERS_GSO;
-  if (opacity != b.opacity)     d |= SEG_DIFFERS_BRI;
-  if (mode != b.mode)           d |= SEG_DIFFERS_FX;
-  if (speed != b.speed)         d |= SEG_DIFFERS_FX;
-  if (intensity != b.intensity) d |= SEG_DIFFERS_FX;
-  if (palette != b.palette)     d |= SEG_DIFFERS_FX;
-  if (custom1 != b.custom1)     d |= SEG_DIFFERS_FX;
-  if (custom2 != b.custom2)     d |= SEG_DIFFERS_FX;
-  if (custom3 != b.custom3)     d |= SEG_DIFFERS_FX;
-  if (startY != b.startY)       d |= SEG_DIFFERS_BOUNDS;
-  if (stopY != b.stopY)         d |= SEG_DIFFERS_BOUNDS;
+  if (memcmp(c+1, s+1, 4) || memcmp(c+32, s+32, 4))  d |= SEG_DIFFERS_BOUNDS;
+  if (memcmp(c+5, s+5, 4))                           d |= SEG_DIFFERS_GSO;
+  if (c[10] != s[10])                                d |= SEG_DIFFERS_BRI;
+  if (memcmp(c+11, s+11, 4) || memcmp(c+29, s+29, 3)) d |= SEG_DIFFERS_FX;
+  if (memcmp(c+15, s+15, 13))                        d |= SEG_DIFFERS_COL; // colors & CCT
 
   //bit pattern: (msb first)
   // set:2, sound:2, mapping:3, transposed, mirrorY, reverseY, [reset,] paused, mirrored, on, reverse, [selected]
-  if ((options & 0b1111111111011110U) != (b.options & 0b1111111111011110U)) d |= SEG_DIFFERS_OPT;
-  if ((options & 0x0001U) != (b.options & 0x0001U))                         d |= SEG_DIFFERS_SEL;
-  for (unsigned i = 0; i < NUM_COLORS; i++) if (colors[i] != b.colors[i])   d |= SEG_DIFFERS_COL;
+  uint16_t o = (s[28] << 8) | s[9];
+  if ((options & 0b1111111111011110U) != (o & 0b1111111111011110U)) d |= SEG_DIFFERS_OPT;
+  if ((options & 0x0001U) != (o & 0x0001U))                         d |= SEG_DIFFERS_SEL;
 
   return d;
 }
 
+// selected, freeze & reset are never taken from state
+void Segment::applyState(const byte *s, uint8_t what) {
+  if (what & SEG_DIFFERS_OPT) options = (options & 0b0000000000110001U) | (((s[28] << 8) | s[9]) & 0b1111111111001110U);
+  if (what & SEG_DIFFERS_BRI) setOpacity(s[10]);
+  if (what & SEG_DIFFERS_FX) {
+    if (s[11] != mode) setMode(s[11]); // do not load defaults
+    speed     = s[12];
+    intensity = s[13];
+    setPalette(s[14]);
+    custom1   = s[29];
+    custom2   = s[30];
+    custom3   = s[31] & 0x1F;
+    check1    = (s[31] >> 5) & 0x1;
+    check2    = (s[31] >> 6) & 0x1;
+    check3    = (s[31] >> 7) & 0x1;
+  }
+  if (what & SEG_DIFFERS_COL) {
+    for (unsigned i = 0; i < NUM_COLORS; i++) setColor(i, RGBW32(s[15+4*i], s[16+4*i], s[17+4*i], s[18+4*i]));
+    setCCT(s[27]);
+  }
+  if (what & (SEG_DIFFERS_BOUNDS | SEG_DIFFERS_GSO)) {
+    bool bounds = what & SEG_DIFFERS_BOUNDS;
+    bool gso    = what & SEG_DIFFERS_GSO;
+    setUp(bounds ? (s[1] << 8 | s[2])   : start,
+          bounds ? (s[3] << 8 | s[4])   : stop,
+          gso    ? s[5]                 : grouping,
+          gso    ? s[6]                 : spacing,
+          gso    ? (s[7] << 8 | s[8])   : offset,
+          bounds ? (s[32] << 8 | s[33]) : startY,
+          bounds ? (s[34] << 8 | s[35]) : stopY);
+  }
+}
+
 void Segment::refreshLightCapabilities() {
   uint8_t capabilities = 0;
   uint16_t segStartIdx = 0xFFFFU;
@@ -1058,7 +1153,7 @@ uint32_t Segment::color_wheel(uint8_t pos) {
 
 /*
  * Gets a single color from the currently selected palette.
- * @param i Palette Index (if mapping is true, the full palette will be _virtualSegmentLength long, if false, 255). Will wrap around automatically.
+ * @param i Palette Index (if mapping is true, the full palette will be SEGLEN long, if false, 255). Will wrap around automatically.
  * @param mapping if true, LED position in segment is considered for color
  * @param wrap FastLED palettes will usually wrap back to the start smoothly. Set false to get a hard edge
  * @param mcol If the default palette 0 is selected, return the standard color 0, 1 or 2 instead. If >2, Party palette is used instead
@@ -1078,11 +1173,20 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
   uint8_t paletteIndex = i;
   if (mapping && virtualLength() > 1) paletteIndex = (i*255)/(virtualLength() -1);
   if (!wrap && strip.paletteBlend != 3) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
-  CRGBPalette16 curPal;
-  curPal = currentPalette(curPal, palette);
-  //if (isInTransition()) curPal = _t->_palT;
-  //else    loadPalette(curPal, palette);
-  CRGB fastled_col = ColorFromPalette(curPal, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
+  CRGB fastled_col;
+  // while the segment is being serviced its palette was already computed in WS2812FX::service(), use the cached copy
+  // (previous effect running during mode blending uses swapped colors so it needs its own palette)
+  #ifndef WLED_DISABLE_MODE_BLEND
+  if (strip.isServicing() && !_modeBlend && this == &strip._segments[strip.getCurrSegmentId()]) {
+  #else
+  if (strip.isServicing() && this == &strip._segments[strip.getCurrSegmentId()]) {
+  #endif
+    fastled_col = strip.colorFromSegmentPalette(paletteIndex, pbri);
+  } else {
+    CRGBPalette16 curPal;
+    curPal = currentPalette(curPal, palette);
+    fastled_col = ColorFromPalette(curPal, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
+  }
 
   return RGBW32(fastled_col.r, fastled_col.g, fastled_col.b, 0);
 }
@@ -1154,74 +1258,178 @@ void WS2812FX::finalizeInit(void)
 
   //segments are created in makeAutoSegments();
   DEBUG_PRINTLN(F("Loading custom palettes"));
-  loadCustomPalettes(); // (re)load all custom palettes
+  loadCustomPalettes(false); // use existing palette bank, compile it only if missing or palette files changed
   DEBUG_PRINTLN(F("Loading custom ledmaps"));
   deserializeMap();     // (re)load default ledmap
+
+  #ifdef WLED_PARALLEL_FX
+  if (!_fxTask) {
+    _loopCore = xPortGetCoreID();
+    _fxStart  = xSemaphoreCreateBinary();
+    _fxDone   = xSemaphoreCreateBinary();
+    if (_fxStart && _fxDone) xTaskCreatePinnedToCore(fxTask, "FX", WLED_FX_TASK_STACK, this, 1, &_fxTask, 1 - _loopCore);
+    DEBUG_PRINTF("FX task %s on core %d\n", _fxTask ? "started" : "failed", 1 - _loopCore);
+  }
+  #endif
 }
 
-void WS2812FX::service() {
-  unsigned long nowUp = millis(); // Be aware, millis() rolls over every 49 days
-  now = nowUp + timebase;
-  if (nowUp - _lastShow < MIN_SHOW_DELAY) return;
+// refresh color_from_palette() cache from render context palette; the pre-interpolated entries are only dropped if palette
+// content (palette, colors or transition progress) or blending mode changed since the cache was built
+void WS2812FX::updatePaletteCache() {
+  render_ctx_t &rc = renderContext();
+  uint8_t blend = (paletteBlend == 3) ? NOBLEND : LINEARBLEND;
+  if (blend == rc.paletteCacheBlend && rc.paletteCache == rc.palette) return;
+  rc.paletteCache = rc.palette;
+  rc.paletteCacheBlend = blend;
+  #ifdef WLED_USE_PALETTE_LUT
+  memset(rc.paletteLUTValid, 0, sizeof(rc.paletteLUTValid));
+  #endif
+}
+
+CRGB WS2812FX::colorFromSegmentPalette(uint8_t index, uint8_t pbri) {
+  render_ctx_t &rc = renderContext();
+  #ifdef WLED_USE_PALETTE_LUT
+  if (pbri == 255) { // most common case, brightness scaling is not cached
+    uint32_t mask = 1UL << (index & 0x1F);
+    if (!(rc.paletteLUTValid[index >> 5] & mask)) {
+      rc.paletteLUT[index] = ColorFromPalette(rc.paletteCache, index, 255, (TBlendType)rc.paletteCacheBlend);
+      rc.paletteLUTValid[index >> 5] |= mask;
+    }
+    return rc.paletteLUT[index];
+  }
+  #endif
+  return ColorFromPalette(rc.paletteCache, index, pbri, (TBlendType)rc.paletteCacheBlend);
+}
+
+// run effect function of a segment that is due, called from service() or FX task (with its own render context)
+// setCCT is false when segments are rendered in parallel, bus CCT is then set once by renderParallel()
+void WS2812FX::renderSegment(Segment &seg, unsigned long nowUp, bool setCCT) {
+  uint16_t delay = FRAMETIME;
+
+  if (!seg.freeze) { //only run effect function if not frozen
+    render_ctx_t &rc = renderContext();
+    rc.segId = &seg - &_segments[0];
+    rc.virtualLength = seg.virtualLength();
+    rc.colors[0] = seg.currentColor(0);
+    rc.colors[1] = seg.currentColor(1);
+    rc.colors[2] = seg.currentColor(2);
+    seg.currentPalette(rc.palette, seg.palette); // we need to pass reference
+    updatePaletteCache();
+
+    if (setCCT && (!cctFromRgb || correctWB)) busses.setSegmentCCT(seg.currentBri(true), correctWB);
+    for (int c = 0; c < NUM_COLORS; c++) rc.colors[c] = gamma32(rc.colors[c]);
+
+    // Effect blending
+    // When two effects are being blended, each may have different segment data, this
+    // data needs to be saved first and then restored before running previous mode.
+    // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
+    // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
+    // would need to be allocated for each effect and then blended together for each pixel.
+    [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
+    unsigned long fxStart = micros();
+    delay = (*_mode[seg.mode])();         // run new/current mode
+#ifndef WLED_DISABLE_MODE_BLEND
+    if (modeBlending && seg.mode != tmpMode) {
+      Segment::tmpsegd_t _tmpSegData;
+      Segment::modeBlend(true);           // set semaphore
+      seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
+      rc.virtualLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
+      uint16_t d2 = (*_mode[tmpMode])();  // run old mode
+      seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
+      delay = MIN(delay,d2);              // use shortest delay
+      Segment::modeBlend(false);          // unset semaphore
+    }
+#endif
+    if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
+    if (seg.isInTransition() && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
+
+    // CPU budget: effect that uses more than its share of the CPU (run time against the update period it is granted)
+    // is updated less often instead of slowing down all segments; throttling only helps if other segments are due too
+    seg.fxTime = (3 * (uint32_t)seg.fxTime + MIN(micros() - fxStart, 0xFFFFUL) + 2) >> 2;
+    uint32_t period = MAX(delay, MIN_SHOW_DELAY) * 1000U; // us
+    uint32_t share  = (uint32_t)seg.fxTime * MAX(_fxShares, 1);
+    if (_fxShares && seg.slowdown < WLED_MAX_FX_SLOWDOWN && share > (period << seg.slowdown)) {
+      seg.slowdown++;
+      DEBUG_PRINTF("Segment %u over budget (%uus), slowdown %u\n", rc.segId, seg.fxTime, seg.slowdown);
+    } else if (seg.slowdown && 4 * share < 3 * (period << (seg.slowdown - 1))) {
+      seg.slowdown--; // fits into the budget at the higher rate (with some headroom)
+    }
+    if (seg.slowdown) delay = MIN((uint32_t)delay << seg.slowdown, 0xFFFFUL);
+  }
+
+  // keep effect cadence: next deadline follows the previous one unless a whole frame slot was missed
+  // (or the segment was rendered well ahead of its deadline because of trigger())
+  long late = nowUp - seg.next_time;
+  if (seg.next_time == 0 || late >= (long)delay || late < -(long)MIN_SHOW_DELAY) {
+    if (seg.next_time && late >= (long)delay) {
+      FX_ENTER_CRITICAL(); // segments may be rendered on both cores
+      _missedDeadlines++;
+      _avgLateness = (3 * _avgLateness + MIN(late, 0xFFFFL) + 2) >> 2;
+      FX_EXIT_CRITICAL();
+    }
+    seg.next_time = nowUp + delay;
+  } else seg.next_time += delay;
+}
+
+// decides which segments are rendered in this frame (in segment order), returns true if the strip needs to be shown
+// - segment is due when its deadline is reached, segments due before the next possible show (MIN_SHOW_DELAY) are
+//   rendered with it instead of requiring another frame shortly after
+// - solid segments only need rendering in between their (slow) deadlines if a segment before them overwrote their LEDs
+bool WS2812FX::scheduleFrame(unsigned long nowUp, uint8_t *due, unsigned &numDue) {
   bool doShow = false;
+  uint32_t pending[(MAX_NUM_SEGMENTS+31)/32] = {0};
+  numDue = 0;
 
-  _isServicing = true;
-  _segment_index = 0;
-  Segment::handleRandomPalette(); // move it into for loop when each segment has individual random palette
-  for (segment &seg : _segments) {
+  for (size_t i = 0; i < _segments.size(); i++) {
+    Segment &seg = _segments[i];
+    renderContext().segId = i;
     // process transition (mode changes in the middle of transition)
     seg.handleTransition();
     // reset the segment runtime data if needed
     seg.resetIfRequired();
-
     if (!seg.isActive()) continue;
-
-    // last condition ensures all solid segments are updated at the same time
-    if (nowUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))
-    {
+    if (_triggered || seg.next_time == 0 || (long)(nowUp - seg.next_time) >= 0) {
       doShow = true;
-      uint16_t delay = FRAMETIME;
-
-      if (!seg.freeze) { //only run effect function if not frozen
-        _virtualSegmentLength = seg.virtualLength();
-        _colors_t[0] = seg.currentColor(0);
-        _colors_t[1] = seg.currentColor(1);
-        _colors_t[2] = seg.currentColor(2);
-        seg.currentPalette(_currentPalette, seg.palette); // we need to pass reference
-
-        if (!cctFromRgb || correctWB) busses.setSegmentCCT(seg.currentBri(true), correctWB);
-        for (int c = 0; c < NUM_COLORS; c++) _colors_t[c] = gamma32(_colors_t[c]);
-
-        // Effect blending
-        // When two effects are being blended, each may have different segment data, this
-        // data needs to be saved first and then restored before running previous mode.
-        // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
-        // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
-        // would need to be allocated for each effect and then blended together for each pixel.
-        [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
-        delay = (*_mode[seg.mode])();         // run new/current mode
-#ifndef WLED_DISABLE_MODE_BLEND
-        if (modeBlending && seg.mode != tmpMode) {
-          Segment::tmpsegd_t _tmpSegData;
-          Segment::modeBlend(true);           // set semaphore
-          seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
-          _virtualSegmentLength = seg.virtualLength(); // update SEGLEN (mapping may have changed)
-          uint16_t d2 = (*_mode[tmpMode])();  // run old mode
-          seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
-          delay = MIN(delay,d2);              // use shortest delay
-          Segment::modeBlend(false);          // unset semaphore
-        }
-#endif
-        if (seg.mode != FX_MODE_HALLOWEEN_EYES) seg.call++;
-        if (seg.isInTransition() && delay > FRAMETIME) delay = FRAMETIME; // force faster updates during transition
-      }
+      if (seg.freeze) seg.next_time = nowUp + FRAMETIME; // frozen segment does not write any LEDs
+      else pending[i >> 5] |= 1UL << (i & 0x1F);
+    }
+  }
+  if (!doShow) return false;
 
-      seg.next_time = nowUp + delay;
+  for (size_t i = 0; i < _segments.size(); i++) {
+    Segment &seg = _segments[i];
+    bool render = pending[i >> 5] & (1UL << (i & 0x1F));
+    if (!render && seg.isActive() && !seg.freeze) {
+      if (seg.mode == FX_MODE_STATIC) {
+        for (unsigned j = 0; j < numDue && !render; j++) render = seg.overlaps(_segments[due[j]]);
+      } else {
+        render = (long)(seg.next_time - nowUp) < (long)MIN_SHOW_DELAY;
+      }
     }
-    if (_segment_index == _queuedChangesSegId) setUpSegmentFromQueuedChanges();
-    _segment_index++;
+    if (render) due[numDue++] = i;
   }
-  _virtualSegmentLength = 0;
+  return true;
+}
+
+void WS2812FX::service() {
+  unsigned long nowUp = millis(); // Be aware, millis() rolls over every 49 days
+  now = nowUp + timebase;
+  // sleep until the earliest segment deadline, trigger() (state change, reset) only has to respect MIN_SHOW_DELAY
+  if ((long)(nowUp - (_triggered ? _lastShow + MIN_SHOW_DELAY : _nextFrame)) < 0) return;
+
+  _isServicing = true;
+  Segment::handleRandomPalette(); // move it into for loop when each segment has individual random palette
+  uint8_t due[MAX_NUM_SEGMENTS];
+  unsigned numDue;
+  bool doShow = scheduleFrame(nowUp, due, numDue);
+  _fxShares = numDue > 1 ? getActiveSegmentsNum() : 0; // no CPU budget if a single segment has the frame to itself
+  #ifdef WLED_PARALLEL_FX
+  if (_fxTask) renderParallel(nowUp, due, numDue);
+  else
+  #endif
+  for (unsigned i = 0; i < numDue; i++) renderSegment(_segments[due[i]], nowUp);
+  setUpSegmentFromQueuedChanges();
+  renderContext().virtualLength = 0;
   busses.setSegmentCCT(-1);
   _isServicing = false;
   _triggered = false;
@@ -1236,8 +1444,76 @@ void WS2812FX::service() {
   #ifdef WLED_DEBUG
   if (millis() - nowUp > _frametime) DEBUG_PRINTLN(F("Slow strip."));
   #endif
+
+  // earliest deadline of all active segments, re-check at least once a second
+  _nextFrame = nowUp + 1000;
+  for (segment &seg : _segments) {
+    if (!seg.isActive()) continue;
+    unsigned long due = seg.isInTransition() ? nowUp + FRAMETIME : seg.next_time; // transitions end in scheduleFrame()
+    if (seg.next_time == 0) due = nowUp;
+    if ((long)(due - _nextFrame) < 0) _nextFrame = due;
+  }
+  if ((long)(_nextFrame - (_lastShow + MIN_SHOW_DELAY)) < 0) _nextFrame = _lastShow + MIN_SHOW_DELAY;
 }
 
+#ifdef WLED_PARALLEL_FX
+portMUX_TYPE fxMux = portMUX_INITIALIZER_UNLOCKED;
+
+void WS2812FX::fxTask(void *parameter) {
+  WS2812FX *fx = static_cast<WS2812FX*>(parameter);
+  for (;;) {
+    xSemaphoreTake(fx->_fxStart, portMAX_DELAY);
+    for (unsigned i = 0; i < fx->_fxTaskSegCount; i++) fx->renderSegment(fx->_segments[fx->_fxTaskSegs[i]], fx->_fxTaskNow, false);
+    fx->renderContext().segId = 255; // idle
+    xSemaphoreGive(fx->_fxDone);
+  }
+}
+
+// renders scheduled segments on both cores
+// segments sharing LEDs are rendered by the same core (in segment order), segments that touch shared state
+// (effect init, custom palette, mode blending) stay on loop task or make the frame sequential
+void WS2812FX::renderParallel(unsigned long nowUp, const uint8_t *due, unsigned numDue) {
+  uint8_t core[MAX_NUM_SEGMENTS]; // 0: loop task, 1: FX task
+  uint32_t load[2] = {0, 0};
+  bool sequential = false;
+  int16_t cct = -1;
+
+  for (unsigned i = 0; i < numDue && !sequential; i++) {
+    Segment &seg = _segments[due[i]];
+    #ifndef WLED_DISABLE_MODE_BLEND
+    if (modeBlending && seg.mode != seg.currentMode()) sequential = true; // Segment::modeBlend() is global
+    #endif
+    if (!cctFromRgb || correctWB) { // bus CCT is global, all segments rendered in parallel need the same
+      int16_t segCCT = seg.currentBri(true);
+      if (cct >= 0 && segCCT != cct) sequential = true;
+      cct = segCCT;
+    }
+
+    // segments sharing LEDs with a segment already assigned go to the same core
+    bool shares[2] = {false, false};
+    for (unsigned j = 0; j < i; j++) if (seg.overlaps(_segments[due[j]])) shares[core[j]] = true;
+    bool loopOnly = seg.call == 0 || seg.palette >= getPaletteCount(); // allocates data or loads custom palette
+    if ((shares[0] && shares[1]) || (loopOnly && shares[1])) sequential = true;
+    uint8_t c = (shares[0] || loopOnly) ? 0 : shares[1] ? 1 : (load[1] < load[0]);
+    core[i] = c;
+    load[c] += seg.length();
+  }
+
+  if (sequential || load[1] == 0) {
+    for (unsigned i = 0; i < numDue; i++) renderSegment(_segments[due[i]], nowUp);
+  } else {
+    _fxTaskSegCount = 0;
+    for (unsigned i = 0; i < numDue; i++) if (core[i]) _fxTaskSegs[_fxTaskSegCount++] = due[i];
+    _fxTaskNow = nowUp;
+    if (!cctFromRgb || correctWB) busses.setSegmentCCT(cct, correctWB); // Bus::setCCT() is not safe to call from both cores
+    xSemaphoreGive(_fxStart);
+    for (unsigned i = 0; i < numDue; i++) if (!core[i]) renderSegment(_segments[due[i]], nowUp, false);
+    xSemaphoreTake(_fxDone, portMAX_DELAY); // all effects must be finished before show()
+    busses.setDirty(); // changed pixel ranges are tracked per bus and not safe to update from both cores
+  }
+}
+#endif
+
 void IRAM_ATTR WS2812FX::setPixelColor(int i, uint32_t col)
 {
   if (i < customMappingSize) i = customMappingTable[i];
@@ -1291,17 +1567,7 @@ uint8_t WS2812FX::estimateCurrentAndLimitBri() {
     if (!IS_DIGITAL(bus->getType())) continue; //exclude non-digital network busses
     uint16_t len = bus->getLength();
     pLen += len;
-    uint32_t busPowerSum = 0;
-    for (uint_fast16_t i = 0; i < len; i++) { //sum up the usage of each LED
-      uint32_t c = bus->getPixelColor(i); // always returns original or restored color without brightness scaling
-      byte r = R(c), g = G(c), b = B(c), w = W(c);
-
-      if(useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
-        busPowerSum += (MAX(MAX(r,g),b)) * 3;
-      } else {
-        busPowerSum += (r + g + b + w);
-      }
-    }
+    uint32_t busPowerSum = bus->getPowerSum(useWackyWS2815PowerModel); //sum up the usage of each LED, cached while bus pixels are unchanged
 
     if (bus->hasWhite()) { //RGBW led total output with white LEDs enabled is still 50mA, so each channel uses less
       busPowerSum *= 3;
@@ -1337,19 +1603,16 @@ void WS2812FX::show(void) {
   show_callback callback = _callback;
   if (callback) callback();
 
+  // limited brightness is kept until the next show() so a steady limit costs no repaint of non-buffered buses
+  // (pixels set in the meantime are painted with it and bus readback compensates for it)
   uint8_t newBri = estimateCurrentAndLimitBri();
-  busses.setBrightness(newBri); // "repaints" all pixels if brightness changed
+  busses.setBrightness(newBri); // applied to pixels in show()
 
   // some buses send asynchronously and this method will return before
   // all of the data has been sent.
   // See https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods#neoesp32rmt-methods
   busses.show();
 
-  // restore bus brightness to its original value
-  // this is done right after show, so this is only OK if LED updates are completed before show() returns
-  // or async show has a separate buffer (ESP32 RMT and I2S are ok)
-  if (newBri < _brightness) busses.setBrightness(_brightness);
-
   unsigned long showNow = millis();
   size_t diff = showNow - _lastShow;
   size_t fpsCurr = 200;
@@ -1420,8 +1683,7 @@ void WS2812FX::setBrightness(uint8_t b, bool direct) {
       seg.freeze = false;
     }
   }
-  // setting brightness with NeoPixelBusLg has no effect on already painted pixels,
-  // so we need to force an update to existing buffer
+  // applied to already painted pixels on next show
   busses.setBrightness(b);
   if (!direct) {
     unsigned long t = millis();
@@ -1542,7 +1804,7 @@ void WS2812FX::setSegment(uint8_t segId, uint16_t i1, uint16_t i2, uint8_t group
 
   if (_queuedChangesSegId == segId) _queuedChangesSegId = 255; // cancel queued change if already queued for this segment
 
-  if (segId < getMaxSegments() && segId == getCurrSegmentId() && isServicing()) { // queue change to prevent concurrent access
+  if (segId < getMaxSegments() && isServicingSegment(segId)) { // queue change to prevent concurrent access
     // queuing a change for a second segment will lead to the loss of the first change if not yet applied
     // however this is not a problem as the queued change is applied immediately after the effect function in that segment returns
     _qStart  = i1; _qStop   = i2; _qStartY = startY; _qStopY  = stopY;
@@ -1575,6 +1837,7 @@ void WS2812FX::resetSegments() {
   #endif
   _segments.push_back(seg);
   _mainSegment = 0;
+  trigger();
 }
 
 void WS2812FX::makeAutoSegments(bool forceReset) {
@@ -1650,6 +1913,7 @@ void WS2812FX::makeAutoSegments(bool forceReset) {
   _mainSegment = 0;
 
   fixInvalidSegments();
+  trigger(); // segment layout changed, render without waiting for the old deadlines
 }
 
 void WS2812FX::fixInvalidSegments() {
@@ -1694,12 +1958,13 @@ bool WS2812FX::checkSegmentAlignment() {
 
 //After this function is called, setPixelColor() will use that segment (offsets, grouping, ... will apply)
 //Note: If called in an interrupt (e.g. JSON API), original segment must be restored,
-//otherwise it can lead to a crash on ESP32 because _segment_index is modified while in use by the main thread
+//otherwise it can lead to a crash on ESP32 because segment index of render context is modified while in use by the main thread
 uint8_t WS2812FX::setPixelSegment(uint8_t n) {
-  uint8_t prevSegId = _segment_index;
+  render_ctx_t &rc = renderContext();
+  uint8_t prevSegId = rc.segId;
   if (n < _segments.size()) {
-    _segment_index = n;
-    _virtualSegmentLength = _segments[_segment_index].virtualLength();
+    rc.segId = n;
+    rc.virtualLength = _segments[n].virtualLength();
   }
   return prevSegId;
 }
@@ -1726,53 +1991,174 @@ void WS2812FX::printSize() {
 }
 #endif
 
-void WS2812FX::loadCustomPalettes() {
-  byte tcp[72]; //support gradient palettes with up to 18 entries
-  CRGBPalette16 targetPalette;
-  customPalettes.clear(); // start fresh
-  for (int index = 0; index<10; index++) {
+/*
+ * Custom palettes are stored as /paletteN.json (N = 0, 1, ...; palette ID 255-N) and compiled into a binary
+ * palette bank (WLED_PALETTE_BANK) so they can be loaded by index without parsing JSON or keeping them in RAM.
+ * Bank format: 12 byte header ('W','P','B', version, palette count, 3 reserved bytes, 32 bit signature of the
+ * palette files) followed by one 72 byte record per palette holding gradient stops (index, R, G, B) in the same
+ * format as gGradientPalettes. Colors are stored without gamma correction, it is applied when a palette is loaded.
+ * A missing /paletteN.json gets an all zero record so that palette IDs of the following files do not change.
+ */
+#define WLED_PALETTE_BANK         "/palettes.bin"
+#define WLED_PALETTE_BANK_VERSION 2
+#define WLED_PALETTE_BANK_HEADER  12
+#define WLED_PALETTE_RECORD_SIZE  72
+
+// converts JSON palette into gradient stops (up to 18 entries, last entry index 255), returns false if invalid
+static bool compileCustomPalette(JsonArray pal, byte *tcp) {
+  if (pal.isNull() || pal.size() <= 3) return false; // empty palette (need at least 2 entries)
+  size_t j = 0;
+  if (pal[0].is<int>() && pal[1].is<const char *>()) {
+    // we have an array of index & hex strings
+    size_t palSize = MIN(pal.size(), 36);
+    palSize -= palSize % 2; // make sure size is multiple of 2
+    for (size_t i=0; i<palSize && pal[i].as<int>()<256; i+=2, j+=4) {
+      uint8_t rgbw[] = {0,0,0,0};
+      tcp[ j ] = (uint8_t) pal[ i ].as<int>(); // index
+      colorFromHexString(rgbw, pal[i+1].as<const char *>()); // will catch non-string entires
+      for (size_t c=0; c<3; c++) tcp[j+1+c] = rgbw[c]; // only use RGB component
+      DEBUG_PRINTF("%d(%d) : %d %d %d\n", i, int(tcp[j]), int(tcp[j+1]), int(tcp[j+2]), int(tcp[j+3]));
+    }
+  } else {
+    size_t palSize = MIN(pal.size(), 72);
+    palSize -= palSize % 4; // make sure size is multiple of 4
+    for (size_t i=0; i<palSize && pal[i].as<int>()<256; i+=4, j+=4) {
+      tcp[ j ] = (uint8_t) pal[ i ].as<int>(); // index
+      tcp[j+1] = (uint8_t) pal[i+1].as<int>(); // R
+      tcp[j+2] = (uint8_t) pal[i+2].as<int>(); // G
+      tcp[j+3] = (uint8_t) pal[i+3].as<int>(); // B
+      DEBUG_PRINTF("%d(%d) : %d %d %d\n", i, int(tcp[j]), int(tcp[j+1]), int(tcp[j+2]), int(tcp[j+3]));
+    }
+  }
+  if (j < 8) return false;
+  tcp[j-4] = 255; // gradient must end at index 255 (loadDynamicGradientPalette() relies on it)
+  for (; j < WLED_PALETTE_RECORD_SIZE; j++) tcp[j] = tcp[j-4]; // pad record with copies of last entry
+  return true;
+}
+
+// fingerprint of the /paletteN.json files (index, size and modification time of each), also changes if
+// a file was edited, added or deleted without going through upload (e.g. with the file editor)
+static uint32_t customPaletteSignature() {
+  uint32_t sig = 2166136261UL;
+  for (int index = 0; index < WLED_MAX_CUSTOM_PALETTES; index++) {
     char fileName[32];
     sprintf_P(fileName, PSTR("/palette%d.json"), index);
+    if (!WLED_FS.exists(fileName)) continue;
+    File f = WLED_FS.open(fileName, "r");
+    if (!f) continue;
+    uint32_t v[3] = {(uint32_t)index, (uint32_t)f.size(), (uint32_t)f.getLastWrite()};
+    f.close();
+    const byte *b = (const byte *)v;
+    for (size_t i = 0; i < sizeof(v); i++) sig = (sig ^ b[i]) * 16777619UL;
+  }
+  return sig;
+}
+
+// (re)compile palette bank from /paletteN.json files; if compile==false an existing bank is used
+// unless it is invalid or the palette files changed since it was compiled
+void WS2812FX::loadCustomPalettes(bool compile) {
+  _customPaletteCount = 0; // no palette is loaded while the bank is being (re)written
+  invalidateCustomPaletteCache();
+
+  byte hdr[WLED_PALETTE_BANK_HEADER];
+  uint32_t sig = customPaletteSignature();
+  if (!compile) {
+    File f = WLED_FS.open(WLED_PALETTE_BANK, "r");
+    if (f && f.read(hdr, sizeof(hdr)) == sizeof(hdr) && hdr[0] == 'W' && hdr[1] == 'P' && hdr[2] == 'B' && hdr[3] == WLED_PALETTE_BANK_VERSION
+        && f.size() >= WLED_PALETTE_BANK_HEADER + hdr[4]*WLED_PALETTE_RECORD_SIZE && memcmp(hdr+8, &sig, sizeof(sig)) == 0) {
+      f.close();
+      _customPaletteCount = hdr[4];
+      DEBUG_PRINTF("Palette bank: %d palettes.\n", (int)_customPaletteCount);
+      return;
+    }
+    if (f) f.close();
+  }
 
-    StaticJsonDocument<1536> pDoc; // barely enough to fit 72 numbers
-    if (WLED_FS.exists(fileName)) {
-      DEBUG_PRINT(F("Reading palette from "));
-      DEBUG_PRINTLN(fileName);
-
-      if (readObjectFromFile(fileName, nullptr, &pDoc)) {
-        JsonArray pal = pDoc[F("palette")];
-        if (!pal.isNull() && pal.size()>3) { // not an empty palette (at least 2 entries)
-          if (pal[0].is<int>() && pal[1].is<const char *>()) {
-            // we have an array of index & hex strings
-            size_t palSize = MIN(pal.size(), 36);
-            palSize -= palSize % 2; // make sure size is multiple of 2
-            for (size_t i=0, j=0; i<palSize && pal[i].as<int>()<256; i+=2, j+=4) {
-              uint8_t rgbw[] = {0,0,0,0};
-              tcp[ j ] = (uint8_t) pal[ i ].as<int>(); // index
-              colorFromHexString(rgbw, pal[i+1].as<const char *>()); // will catch non-string entires
-              for (size_t c=0; c<3; c++) tcp[j+1+c] = gamma8(rgbw[c]); // only use RGB component
-              DEBUG_PRINTF("%d(%d) : %d %d %d\n", i, int(tcp[j]), int(tcp[j+1]), int(tcp[j+2]), int(tcp[j+3]));
-            }
-          } else {
-            size_t palSize = MIN(pal.size(), 72);
-            palSize -= palSize % 4; // make sure size is multiple of 4
-            for (size_t i=0; i<palSize && pal[i].as<int>()<256; i+=4) {
-              tcp[ i ] = (uint8_t) pal[ i ].as<int>(); // index
-              tcp[i+1] = gamma8((uint8_t) pal[i+1].as<int>()); // R
-              tcp[i+2] = gamma8((uint8_t) pal[i+2].as<int>()); // G
-              tcp[i+3] = gamma8((uint8_t) pal[i+3].as<int>()); // B
-              DEBUG_PRINTF("%d(%d) : %d %d %d\n", i, int(tcp[i]), int(tcp[i+1]), int(tcp[i+2]), int(tcp[i+3]));
-            }
-          }
-          customPalettes.push_back(targetPalette.loadDynamicGradientPalette(tcp));
-        } else {
-          DEBUG_PRINTLN(F("Wrong palette format."));
-        }
+  File bank = WLED_FS.open(WLED_PALETTE_BANK, "w");
+  if (!bank) {
+    DEBUG_PRINTLN(F("Cannot create palette bank."));
+    return;
+  }
+  memset(hdr, 0, sizeof(hdr));
+  hdr[0] = 'W'; hdr[1] = 'P'; hdr[2] = 'B'; hdr[3] = WLED_PALETTE_BANK_VERSION;
+  memcpy(hdr+8, &sig, sizeof(sig));
+  bank.write(hdr, sizeof(hdr));
+
+  byte tcp[WLED_PALETTE_RECORD_SIZE]; //support gradient palettes with up to 18 entries
+  StaticJsonDocument<1536> pDoc; // barely enough to fit 72 numbers
+  unsigned count = 0; // written records (up to and including last existing file)
+  for (int index = 0; index < WLED_MAX_CUSTOM_PALETTES; index++) {
+    char fileName[32];
+    sprintf_P(fileName, PSTR("/palette%d.json"), index);
+    if (!WLED_FS.exists(fileName)) continue;
+
+    DEBUG_PRINT(F("Reading palette from "));
+    DEBUG_PRINTLN(fileName);
+    pDoc.clear();
+    if (!readObjectFromFile(fileName, nullptr, &pDoc) || !compileCustomPalette(pDoc[F("palette")], tcp)) {
+      DEBUG_PRINTLN(F("Wrong palette format."));
+      memset(tcp, 0, sizeof(tcp)); // keep its ID (and file name) but make it black
+      for (size_t j = 4; j < sizeof(tcp); j += 4) tcp[j] = 255;
+    }
+    if (index > (int)count) { // empty records for missing files keep palette IDs stable
+      byte empty[WLED_PALETTE_RECORD_SIZE] = {0};
+      for (; (int)count < index; count++) bank.write(empty, sizeof(empty));
+    }
+    bank.write(tcp, WLED_PALETTE_RECORD_SIZE);
+    count++;
+  }
+  hdr[4] = count;
+  bank.seek(0);
+  bank.write(hdr, sizeof(hdr));
+  bank.close();
+  _customPaletteCount = count;
+  DEBUG_PRINTF("Palette bank: %d palettes compiled.\n", count);
+}
+
+// load custom palette (index 0 is palette ID 255) from RAM cache or palette bank, gamma is applied to the colors
+// the cache may only be used from the loop task, other tasks (web server, segment changes from JSON) must pass useCache=false
+// returns false if palette does not exist (or its file is missing)
+bool WS2812FX::loadCustomPalette(uint8_t index, CRGBPalette16 &targetPalette, bool useCache) {
+  if (index >= _customPaletteCount) return false;
+  unsigned slot = 0;
+  if (useCache) {
+    if (_customPaletteCacheGen != _customPaletteGen) { // gamma or palette bank changed
+      for (auto &c : _customPaletteCache) c.index = 255;
+      _customPaletteCacheGen = _customPaletteGen;
+    }
+    _customPaletteUse++;
+    for (unsigned i = 0; i < WLED_CUSTOM_PALETTE_CACHE; i++) {
+      if (_customPaletteCache[i].index == index) {
+        _customPaletteCache[i].lastUse = _customPaletteUse;
+        targetPalette = _customPaletteCache[i].palette;
+        return true;
       }
-    } else {
-      break;
+      // prefer empty slot, otherwise least recently used one
+      if (_customPaletteCache[slot].index == 255) continue;
+      if (_customPaletteCache[i].index == 255 || uint8_t(_customPaletteUse - _customPaletteCache[i].lastUse) > uint8_t(_customPaletteUse - _customPaletteCache[slot].lastUse)) slot = i;
     }
   }
+
+  byte tcp[WLED_PALETTE_RECORD_SIZE];
+  File f = WLED_FS.open(WLED_PALETTE_BANK, "r");
+  if (!f) return false;
+  bool ok = f.seek(WLED_PALETTE_BANK_HEADER + index*WLED_PALETTE_RECORD_SIZE) && f.read(tcp, sizeof(tcp)) == sizeof(tcp);
+  f.close();
+  if (!ok || tcp[WLED_PALETTE_RECORD_SIZE-4] != 255) return false; // every valid record ends with index 255
+  for (size_t j = 0; j < sizeof(tcp); j += 4) {
+    tcp[j+1] = gamma8(tcp[j+1]);
+    tcp[j+2] = gamma8(tcp[j+2]);
+    tcp[j+3] = gamma8(tcp[j+3]);
+  }
+  if (!useCache) {
+    targetPalette.loadDynamicGradientPalette(tcp);
+    return true;
+  }
+  _customPaletteCache[slot].palette.loadDynamicGradientPalette(tcp);
+  _customPaletteCache[slot].index   = index;
+  _customPaletteCache[slot].lastUse = _customPaletteUse;
+  targetPalette = _customPaletteCache[slot].palette;
+  return true;
 }
 
 //load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
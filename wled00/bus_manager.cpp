@@ -10,12 +10,12 @@
 #include "bus_manager.h"
 
 //colors.cpp
-uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb);
+void colorKtoRGB(uint16_t kelvin, byte* rgb);
 uint16_t approximateKelvinFromRGB(uint32_t rgb);
 void colorRGBtoRGBW(byte* rgb);
 
 //udp.cpp
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false, uint16_t start=0);
 
 // enable additional debug output
 #if defined(WLED_DEBUG_HOST)
@@ -91,18 +91,120 @@ uint32_t Bus::autoWhiteCalc(uint32_t c) {
   return RGBW32(r, g, b, w);
 }
 
+// CCT is set for every segment in every frame, remember the correction for a few recent color temperatures
+// so that slow colorKtoRGB() does not run each time segments with different CCT alternate
+#define WLED_CCT_CORRECTION_CACHE 4
+void Bus::setCCT(int16_t cct) {
+  static struct { int16_t kelvin; uint8_t rgb[3]; } cache[WLED_CCT_CORRECTION_CACHE] = {};
+  static uint8_t next = 0;
+  if (cct == _cct) return;
+  if (cct >= 1900) {
+    unsigned i = 0;
+    while (i < WLED_CCT_CORRECTION_CACHE && cache[i].kelvin != cct) i++;
+    if (i < WLED_CCT_CORRECTION_CACHE) memcpy(_cctRGB, cache[i].rgb, 3);
+    else {
+      byte rgb[4];
+      colorKtoRGB(cct, rgb);  // convert Kelvin to RGB
+      memcpy(_cctRGB, rgb, 3);
+      cache[next].kelvin = cct;
+      memcpy(cache[next].rgb, rgb, 3);
+      next = (next + 1) % WLED_CCT_CORRECTION_CACHE;
+    }
+  }
+  _cct = cct; // only after _cctRGB matches it
+}
+
+// white balance correction from CCT (same result as colorBalanceFromKelvin())
+uint32_t IRAM_ATTR Bus::colorBalance(uint32_t c) {
+  return RGBW32(((uint16_t)_cctRGB[0] * R(c)) / 255,
+                ((uint16_t)_cctRGB[1] * G(c)) / 255,
+                ((uint16_t)_cctRGB[2] * B(c)) / 255,
+                W(c));
+}
+
 uint8_t *Bus::allocData(size_t size) {
   if (_data) free(_data); // should not happen, but for safety
   return _data = (uint8_t *)(size>0 ? calloc(size, sizeof(uint8_t)) : nullptr);
 }
 
+// true if frame (and brightness) differs from the last one sent or keep-alive interval elapsed
+// refresh is never skipped for buses that need it to remain off
+bool Bus::frameChanged(const uint8_t *data, size_t size) {
+  uint32_t hash = 2166136261UL ^ _bri;
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    uint32_t w;
+    memcpy(&w, data + i, 4);
+    hash = (hash ^ w) * 16777619UL;
+    hash ^= hash >> 15;
+  }
+  for (; i < size; i++) hash = (hash ^ data[i]) * 16777619UL;
+  unsigned long now = millis();
+  if (hash == _frameHash && !_needsRefresh && now - _lastSent < _keepAlive) return false;
+  _frameHash = hash;
+  _lastSent  = now;
+  return true;
+}
+
+// pixels of the current frame that need to be sent: first ... last-1, false if there is nothing to send
+// whole bus is sent if refresh is requested, keep-alive interval elapsed, bus needs refresh or can only send full frames
+bool Bus::frameRange(uint16_t &first, uint16_t &last, bool refresh, bool partial) {
+  if (!_front) takeDirty(); // otherwise latch() took the changes together with the pixels
+  unsigned long now = millis();
+  if (refresh || _needsRefresh || now - _lastSent >= _keepAlive) {
+    first = 0;
+    last  = _len;
+  } else if (_frameStart < _frameEnd) {
+    first = partial ? _frameStart : 0;
+    last  = partial ? MIN(_frameEnd, _len) : _len;
+  } else return false;
+  _lastSent = now;
+  return true;
+}
+
+// front buffer is only allocated once a bus is shown asynchronously
+bool Bus::latchData(size_t size) {
+  if (!_data || !size) return false;
+  if (!_front) _front = (uint8_t *)malloc(size);
+  if (!_front) return false;
+  memcpy(_front, _data, size);
+  takeDirty();
+  return true;
+}
+
+// sum of channel values of all pixels (brightest of R,G,B per channel for WS2815), used for current estimation
+// digital and network buses with a pixel buffer only sum up again if pixels changed since last call
+uint32_t Bus::getPowerSum(bool ws2815) {
+  uint8_t model = ws2815 ? 2 : 1;
+  if (_data && IS_DIGITAL(_type) && _powerModel == model) return _powerSum;
+  uint32_t sum = 0;
+  uint16_t len = getLength();
+  for (uint_fast16_t i = 0; i < len; i++) {
+    uint32_t c = getPixelColor(i); // always returns original or restored color without brightness scaling
+    byte r = R(c), g = G(c), b = B(c), w = W(c);
+    if (ws2815) sum += (MAX(MAX(r,g),b)) * 3; //ignore white component on WS2815 power calculation
+    else        sum += (r + g + b + w);
+  }
+  _powerSum   = sum;
+  _powerModel = model;
+  return sum;
+}
+
 
 BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 : Bus(bc.type, bc.start, bc.autoWhite, bc.count, bc.reversed, (bc.refreshReq || bc.type == TYPE_TM1814))
 , _skip(bc.skipAmount) //sacrificial pixels
 , _colorOrder(bc.colorOrder)
+, _iType(I_NONE)
+, _busPtr(nullptr)
+, _fns(nullptr)
 , _colorOrderMap(com)
+, _numColorOrderRuns(1)
+, _paintedBri(255)
+, _consistent(false)
 {
+  _colorOrderRuns[0].start = _start;
+  _colorOrderRuns[0].colorOrder = _colorOrder;
   if (!IS_DIGITAL(bc.type) || !bc.count) return;
   if (!pinManager.allocatePin(bc.pins[0], true, PinOwner::BusDigital)) return;
   _frequencykHz = 0U;
@@ -117,50 +219,83 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
   }
   _iType = PolyBus::getI(bc.type, _pins, nr);
   if (_iType == I_NONE) return;
-  if (bc.doubleBuffer && !allocData(bc.count * (Bus::hasWhite(_type) + 3*Bus::hasRGB(_type)))) return; //warning: hardcoded channel count
+  updateColorOrder();
+  if (bc.doubleBuffer && !allocData(bc.count * (_hasWhite + 3*_hasRgb))) return; //warning: hardcoded channel count
   _buffering = bc.doubleBuffer;
   uint16_t lenToCreate = bc.count;
   if (bc.type == TYPE_WS2812_1CH_X3) lenToCreate = NUM_ICS_WS2812_1CH_3X(bc.count); // only needs a third of "RGB" LEDs for NeoPixelBus
   _busPtr = PolyBus::create(_iType, _pins, lenToCreate + _skip, nr, _frequencykHz);
-  _valid = (_busPtr != nullptr);
+  _fns = PolyBus::getFunctions(_iType);
+  _valid = (_busPtr != nullptr && _fns != nullptr);
   DEBUG_PRINTF("%successfully inited strip %u (len %u) with type %u and pins %u,%u (itype %u)\n", _valid?"S":"Uns", nr, bc.count, bc.type, _pins[0], _pins[1], _iType);
 }
 
 void BusDigital::show() {
   if (!_valid) return;
+  bool consistent = true;
   if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
-    size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
-    for (size_t i=0; i<_len; i++) {
+    size_t channels = _hasWhite + 3*_hasRgb;
+    const uint8_t *data = showData();
+    uint16_t from, to; // only pixels changed since last frame need converting if NeoPixelBus buffer still holds it
+    if (!frameRange(from, to, _paintedBri != _bri || !_consistent)) return; // skip conversion too
+    // keep NeoPixelBus buffer consistent (costs a copy in show) only while few pixels change per frame
+    consistent = _frameStart >= _frameEnd || unsigned(_frameEnd - _frameStart) < _len/2U;
+    applyBrightness();
+    if (_hasRgb) {
+      // one call per color order run (whole bus if there is no color order map entry for it)
+      for (unsigned r = 0; r < _numColorOrderRuns; r++) {
+        unsigned first = _colorOrderRuns[r].start - _start;
+        unsigned last  = (r+1 < _numColorOrderRuns) ? _colorOrderRuns[r+1].start - _start : _len;
+        if (first < from) first = from;
+        if (last > to) last = to;
+        if (first >= last) continue;
+        unsigned pix = _reversed ? _len - last : first;
+        _fns->setPixels(_busPtr, pix + _skip, data + first*channels, last - first, channels, _reversed, _colorOrderRuns[r].colorOrder);
+      }
+    } else for (size_t i=from; i<to; i++) {
       size_t offset = i*channels;
-      uint8_t co = _colorOrderMap.getPixelColorOrder(i+_start, _colorOrder);
+      uint8_t co = pixelColorOrder(i+_start);
       uint32_t c;
       if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3)
         switch (i%3) {
-          case 0: c = RGBW32(_data[offset]  , _data[offset+1], _data[offset+2], 0); break;
-          case 1: c = RGBW32(_data[offset-1], _data[offset]  , _data[offset+1], 0); break;
-          case 2: c = RGBW32(_data[offset-2], _data[offset-1], _data[offset]  , 0); break;
+          case 0: c = RGBW32(data[offset]  , data[offset+1], data[offset+2], 0); break;
+          case 1: c = RGBW32(data[offset-1], data[offset]  , data[offset+1], 0); break;
+          case 2: c = RGBW32(data[offset-2], data[offset-1], data[offset]  , 0); break;
         }
       } else {
-        c = RGBW32(_data[offset],_data[offset+1],_data[offset+2],(Bus::hasWhite(_type)?_data[offset+3]:0));
+        c = RGBW32(data[offset],data[offset+1],data[offset+2],(_hasWhite?data[offset+3]:0));
       }
       uint16_t pix = i;
       if (_reversed) pix = _len - pix -1;
       pix += _skip;
-      PolyBus::setPixelColor(_busPtr, _iType, pix, c, co);
+      _fns->setPixelColor(_busPtr, pix, c, co);
     }
     #if !defined(STATUSLED) || STATUSLED>=0
-    if (_skip) PolyBus::setPixelColor(_busPtr, _iType, 0, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
+    if (_skip) _fns->setPixelColor(_busPtr, 0, 0, pixelColorOrder(_start)); // paint skipped pixels black
     #endif
-    for (int i=1; i<_skip; i++) PolyBus::setPixelColor(_busPtr, _iType, i, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
+    for (int i=1; i<_skip; i++) _fns->setPixelColor(_busPtr, i, 0, pixelColorOrder(_start)); // paint skipped pixels black
+  } else {
+    applyBrightness();
+    size_t size;
+    const uint8_t *pixels = _fns->pixels(_busPtr, size);
+    if (!frameChanged(pixels, size)) return;
   }
-  PolyBus::show(_busPtr, _iType, !_buffering); // faster if buffer consistency is not important
+  _fns->show(_busPtr, consistent); // faster if buffer consistency is not important
+  _consistent = consistent;
+}
+
+// only double buffered bus can be sent from its copy, otherwise effects write into NeoPixelBus buffer directly
+bool BusDigital::latch() {
+  if (!_valid || !_buffering) return false;
+  return latchData(_len * (_hasWhite + 3*_hasRgb));
 }
 
 bool BusDigital::canShow() {
   if (!_valid) return true;
-  return PolyBus::canShow(_busPtr, _iType);
+  return _fns->canShow(_busPtr);
 }
 
+// new brightness is applied to the LEDs in show(), pixels set in the meantime are still painted with the previous one
 void BusDigital::setBrightness(uint8_t b) {
   if (_bri == b) return;
   //Fix for turning off onboard LED breaking bus
@@ -169,21 +304,25 @@ void BusDigital::setBrightness(uint8_t b) {
     if (_pins[0] == LED_BUILTIN || _pins[1] == LED_BUILTIN) reinit();
   }
   #endif
-  uint8_t prevBri = _bri;
   Bus::setBrightness(b);
-  PolyBus::setBrightness(_busPtr, _iType, b);
+}
+
+// NeoPixelBusLg scales pixels as they are set, so changing its luminance has no effect on already painted pixels
+// double buffered bus repaints everything from unscaled buffer anyway, otherwise NeoPixelBus buffer is rescaled once
+void BusDigital::applyBrightness() {
+  if (_paintedBri == _bri) return;
+  uint8_t prevBri = _paintedBri;
+  PolyBus::setBrightness(_busPtr, _iType, _bri);
+  _paintedBri = _bri;
 
   if (_buffering) return;
 
-  // must update/repaint every LED in the NeoPixelBus buffer to the new brightness
-  // the only case where repainting is unnecessary is when all pixels are set after the brightness change but before the next show
-  // (which we can't rely on)
   uint16_t hwLen = _len;
   if (_type == TYPE_WS2812_1CH_X3) hwLen = NUM_ICS_WS2812_1CH_3X(_len); // only needs a third of "RGB" LEDs for NeoPixelBus
   for (uint_fast16_t i = 0; i < hwLen; i++) {
     // use 0 as color order, actual order does not matter here as we just update the channel values as-is
-    uint32_t c = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, i, 0),prevBri);
-    PolyBus::setPixelColor(_busPtr, _iType, i, c, 0);
+    uint32_t c = restoreColorLossy(_fns->getPixelColor(_busPtr, i, 0),prevBri);
+    _fns->setPixelColor(_busPtr, i, c, 0);
   }
 }
 
@@ -191,39 +330,43 @@ void BusDigital::setBrightness(uint8_t b) {
 //TODO only show if no new show due in the next 50ms
 void BusDigital::setStatusPixel(uint32_t c) {
   if (_valid && _skip) {
-    PolyBus::setPixelColor(_busPtr, _iType, 0, c, _colorOrderMap.getPixelColorOrder(_start, _colorOrder));
-    if (canShow()) PolyBus::show(_busPtr, _iType);
+    _fns->setPixelColor(_busPtr, 0, c, pixelColorOrder(_start));
+    if (canShow()) _fns->show(_busPtr, true);
+    forceSend(); // next frame overwrites status pixel
   }
 }
 
 void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   if (!_valid) return;
-  if (Bus::hasWhite(_type)) c = autoWhiteCalc(c);
-  if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
+  if (_hasWhite) c = autoWhiteCalc(c);
+  if (_cct >= 1900) c = colorBalance(c); //color correction from CCT
   if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
-    size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
-    size_t offset = pix*channels;
-    if (Bus::hasRGB(_type)) {
-      _data[offset++] = R(c);
-      _data[offset++] = G(c);
-      _data[offset++] = B(c);
-    }
-    if (Bus::hasWhite(_type)) _data[offset] = W(c);
+    size_t channels = _hasWhite + 3*_hasRgb;
+    uint8_t *d = _data + pix*channels;
+    if (_hasRgb) {
+      if (d[0] == R(c) && d[1] == G(c) && d[2] == B(c) && (!_hasWhite || d[3] == W(c))) return;
+      d[0] = R(c);
+      d[1] = G(c);
+      d[2] = B(c);
+      d += 3;
+    } else if (d[0] == W(c)) return;
+    if (_hasWhite) d[0] = W(c);
+    markDirty(pix);
   } else {
     if (_reversed) pix = _len - pix -1;
     pix += _skip;
-    uint8_t co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
+    uint8_t co = pixelColorOrder(pix+_start);
     if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
       uint16_t pOld = pix;
       pix = IC_INDEX_WS2812_1CH_3X(pix);
-      uint32_t cOld = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, pix, co),_bri);
+      uint32_t cOld = restoreColorLossy(_fns->getPixelColor(_busPtr, pix, co),_paintedBri);
       switch (pOld % 3) { // change only the single channel (TODO: this can cause loss because of get/set)
         case 0: c = RGBW32(R(cOld), W(c)   , B(cOld), 0); break;
         case 1: c = RGBW32(W(c)   , G(cOld), B(cOld), 0); break;
         case 2: c = RGBW32(R(cOld), G(cOld), W(c)   , 0); break;
       }
     }
-    PolyBus::setPixelColor(_busPtr, _iType, pix, c, co);
+    _fns->setPixelColor(_busPtr, pix, c, co);
   }
 }
 
@@ -231,20 +374,20 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
 uint32_t BusDigital::getPixelColor(uint16_t pix) {
   if (!_valid) return 0;
   if (_buffering) { // should be _data != nullptr, but that causes ~20% FPS drop
-    size_t channels = Bus::hasWhite(_type) + 3*Bus::hasRGB(_type);
+    size_t channels = _hasWhite + 3*_hasRgb;
     size_t offset = pix*channels;
     uint32_t c;
-    if (!Bus::hasRGB(_type)) {
+    if (!_hasRgb) {
       c = RGBW32(_data[offset], _data[offset], _data[offset], _data[offset]);
     } else {
-      c = RGBW32(_data[offset], _data[offset+1], _data[offset+2], Bus::hasWhite(_type) ? _data[offset+3] : 0);
+      c = RGBW32(_data[offset], _data[offset+1], _data[offset+2], _hasWhite ? _data[offset+3] : 0);
     }
     return c;
   } else {
     if (_reversed) pix = _len - pix -1;
     pix += _skip;
-    uint8_t co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
-    uint32_t c = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, (_type==TYPE_WS2812_1CH_X3) ? IC_INDEX_WS2812_1CH_3X(pix) : pix, co),_bri);
+    uint8_t co = pixelColorOrder(pix+_start);
+    uint32_t c = restoreColorLossy(_fns->getPixelColor(_busPtr, (_type==TYPE_WS2812_1CH_X3) ? IC_INDEX_WS2812_1CH_3X(pix) : pix, co),_paintedBri);
     if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
       uint8_t r = R(c);
       uint8_t g = _reversed ? B(c) : G(c); // should G and B be switched if _reversed?
@@ -269,11 +412,42 @@ void BusDigital::setColorOrder(uint8_t colorOrder) {
   // upper nibble contains W swap information
   if ((colorOrder & 0x0F) > 5) return;
   _colorOrder = colorOrder;
+  updateColorOrder();
+}
+
+// compile color order map into sorted runs covering this bus (including skipped LEDs)
+// first matching map entry wins, same as ColorOrderMap::getPixelColorOrder()
+void BusDigital::updateColorOrder() {
+  uint32_t busEnd = _start + _len + _skip;
+  uint16_t bounds[2*WLED_MAX_COLOR_ORDER_MAPPINGS+1];
+  unsigned numBounds = 0;
+  bounds[numBounds++] = _start;
+  for (unsigned i = 0; i < _colorOrderMap.count(); i++) {
+    const ColorOrderMapEntry *e = _colorOrderMap.get(i);
+    uint32_t edges[2] = { e->start, (uint32_t)e->start + e->len };
+    for (unsigned j = 0; j < 2; j++) {
+      if (edges[j] <= _start || edges[j] >= busEnd) continue;
+      unsigned k = numBounds++; // insertion sort, there are only a few entries
+      while (k > 0 && bounds[k-1] > edges[j]) { bounds[k] = bounds[k-1]; k--; }
+      bounds[k] = edges[j];
+    }
+  }
+  // order is constant between two boundaries, merge neighbours with the same order
+  _numColorOrderRuns = 0;
+  for (unsigned i = 0; i < numBounds; i++) {
+    uint8_t co = _colorOrderMap.getPixelColorOrder(bounds[i], _colorOrder);
+    if (_numColorOrderRuns && _colorOrderRuns[_numColorOrderRuns-1].colorOrder == co) continue;
+    _colorOrderRuns[_numColorOrderRuns].start = bounds[i];
+    _colorOrderRuns[_numColorOrderRuns].colorOrder = co;
+    _numColorOrderRuns++;
+  }
+  forceSend();
 }
 
 void BusDigital::reinit() {
   if (!_valid) return;
   PolyBus::begin(_busPtr, _iType, _pins);
+  forceSend();
 }
 
 void BusDigital::cleanup() {
@@ -326,7 +500,7 @@ void BusPwm::setPixelColor(uint16_t pix, uint32_t c) {
   if (pix != 0 || !_valid) return; //only react to first pixel
   if (_type != TYPE_ANALOG_3CH) c = autoWhiteCalc(c);
   if (_cct >= 1900 && (_type == TYPE_ANALOG_3CH || _type == TYPE_ANALOG_4CH)) {
-    c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
+    c = colorBalance(c); //color correction from CCT
   }
   uint8_t r = R(c);
   uint8_t g = G(c);
@@ -483,6 +657,7 @@ BusNetwork::BusNetwork(BusConfig &bc)
       break;
   }
   _UDPchannels = _rgbw ? 4 : 3;
+  _sentBri = 0;
   _client = IPAddress(bc.pins[0],bc.pins[1],bc.pins[2],bc.pins[3]);
   _valid = (allocData(_len * _UDPchannels) != nullptr);
 }
@@ -490,12 +665,14 @@ BusNetwork::BusNetwork(BusConfig &bc)
 void BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
   if (!_valid || pix >= _len) return;
   if (_rgbw) c = autoWhiteCalc(c);
-  if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
-  uint16_t offset = pix * _UDPchannels;
-  _data[offset]   = R(c);
-  _data[offset+1] = G(c);
-  _data[offset+2] = B(c);
-  if (_rgbw) _data[offset+3] = W(c);
+  if (_cct >= 1900) c = colorBalance(c); //color correction from CCT
+  uint8_t *d = _data + pix * _UDPchannels;
+  if (d[0] == R(c) && d[1] == G(c) && d[2] == B(c) && (!_rgbw || d[3] == W(c))) return;
+  d[0] = R(c);
+  d[1] = G(c);
+  d[2] = B(c);
+  if (_rgbw) d[3] = W(c);
+  markDirty(pix);
 }
 
 uint32_t BusNetwork::getPixelColor(uint16_t pix) {
@@ -506,8 +683,11 @@ uint32_t BusNetwork::getPixelColor(uint16_t pix) {
 
 void BusNetwork::show() {
   if (!_valid || !canShow()) return;
+  uint16_t first, last; // only DDP can address part of the display, send changed pixels only (saves airtime)
+  if (!frameRange(first, last, _bri != _sentBri, _UDPtype == 0)) return;
+  _sentBri = _bri;
   _broadcastLock = true;
-  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw);
+  realtimeBroadcast(_UDPtype, _client, last - first, (uint8_t*)showData(), _bri, _rgbw, first);
   _broadcastLock = false;
 }
 
@@ -565,18 +745,54 @@ int BusManager::add(BusConfig &bc) {
 void BusManager::removeAll() {
   DEBUG_PRINTLN(F("Removing all."));
   //prevents crashes due to deleting busses while in use.
+  waitForShow();
   while (!canAllShow()) yield();
   for (uint8_t i = 0; i < numBusses; i++) delete busses[i];
   numBusses = 0;
 }
 
+#ifdef WLED_ASYNC_SHOW
+void BusManager::showTask(void *parameter) {
+  BusManager *bm = static_cast<BusManager*>(parameter);
+  for (;;) {
+    xSemaphoreTake(bm->_showStart, portMAX_DELAY);
+    for (uint8_t i = 0; i < bm->numBusses; i++) {
+      if (bm->_latched & (1UL << i)) bm->busses[i]->show(); // may wait for previous transmission to finish
+    }
+    xSemaphoreGive(bm->_showDone);
+  }
+}
+#endif
+
 void BusManager::show() {
+  #ifdef WLED_ASYNC_SHOW
+  if (!_showTask) {
+    _showStart = xSemaphoreCreateBinary();
+    _showDone  = xSemaphoreCreateBinary();
+    if (_showStart && _showDone) {
+      xSemaphoreGive(_showDone);
+      xTaskCreateUniversal(showTask, "Show", WLED_SHOW_TASK_STACK, this, 2, &_showTask, tskNO_AFFINITY);
+    }
+    DEBUG_PRINTF("Show task %s\n", _showTask ? "started" : "failed");
+  }
+  if (_showTask) {
+    xSemaphoreTake(_showDone, portMAX_DELAY); // previous frame must be handed to hardware before its copy is overwritten
+    _latched = 0;
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (busses[i]->latch()) _latched |= 1UL << i;
+      else busses[i]->show(); // cheap (PWM) or shares its buffer with effects
+    }
+    xSemaphoreGive(_latched ? _showStart : _showDone);
+    return;
+  }
+  #endif
   for (uint8_t i = 0; i < numBusses; i++) {
     busses[i]->show();
   }
 }
 
 void BusManager::setStatusPixel(uint32_t c) {
+  waitForShow();
   for (uint8_t i = 0; i < numBusses; i++) {
     busses[i]->setStatusPixel(c);
   }
@@ -592,6 +808,7 @@ void IRAM_ATTR BusManager::setPixelColor(uint16_t pix, uint32_t c) {
 }
 
 void BusManager::setBrightness(uint8_t b) {
+  waitForShow(); // brightness is applied when bus is shown
   for (uint8_t i = 0; i < numBusses; i++) {
     busses[i]->setBrightness(b);
   }
@@ -606,6 +823,18 @@ void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
   Bus::setCCT(cct);
 }
 
+void BusManager::setDirty() {
+  for (uint8_t i = 0; i < numBusses; i++) busses[i]->setDirty();
+}
+
+void BusManager::updateColorOrderMap(const ColorOrderMap &com) {
+  memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap));
+  for (uint8_t i = 0; i < numBusses; i++) {
+    uint8_t type = busses[i]->getType();
+    if (IS_DIGITAL(type) && type < TYPE_NET_DDP_RGB) static_cast<BusDigital*>(busses[i])->updateColorOrder(); // network types are digital too
+  }
+}
+
 uint32_t BusManager::getPixelColor(uint16_t pix) {
   for (uint8_t i = 0; i < numBusses; i++) {
     Bus* b = busses[i];
@@ -617,6 +846,9 @@ uint32_t BusManager::getPixelColor(uint16_t pix) {
 }
 
 bool BusManager::canAllShow() {
+  #ifdef WLED_ASYNC_SHOW
+  if (_showTask && !uxSemaphoreGetCount(_showDone)) return false; // show task is still sending
+  #endif
   for (uint8_t i = 0; i < numBusses; i++) {
     if (!busses[i]->canShow()) return false;
   }
@@ -638,4 +870,6 @@ uint16_t BusManager::getTotalLength() {
 // Bus static member definition
 int16_t Bus::_cct = -1;
 uint8_t Bus::_cctBlend = 0;
+uint8_t Bus::_cctRGB[3] = {255, 255, 255};
 uint8_t Bus::_gAWM = 255;
+uint16_t Bus::_keepAlive = WLED_BUS_KEEPALIVE;
@@ -21,6 +21,20 @@
 // flag for using double buffering in BusDigital
 extern bool useGlobalLedBuffer;
 
+// unchanged frames are not sent again until keep-alive interval (ms) elapses, 0 sends every frame
+#ifndef WLED_BUS_KEEPALIVE
+  #define WLED_BUS_KEEPALIVE 1000
+#endif
+
+// ESP32: double buffered and network buses are transmitted by a separate task from a copy of their buffer,
+// so effects may render the next frame while the previous one is being sent (opt-in)
+#if defined(WLED_ENABLE_ASYNC_SHOW) && defined(ARDUINO_ARCH_ESP32)
+  #define WLED_ASYNC_SHOW
+  #ifndef WLED_SHOW_TASK_STACK
+    #define WLED_SHOW_TASK_STACK 4096
+  #endif
+#endif
+
 
 //temporary struct for passing bus configuration to bus
 struct BusConfig {
@@ -76,6 +90,12 @@ struct ColorOrderMapEntry {
   uint8_t colorOrder;
 };
 
+// color order of consecutive pixels of a bus, valid until start of next run (or end of bus)
+struct ColorOrderRun {
+  uint16_t start;
+  uint8_t colorOrder;
+};
+
 struct ColorOrderMap {
     void add(uint16_t start, uint16_t len, uint8_t colorOrder);
 
@@ -113,13 +133,25 @@ class Bus {
     , _valid(false)
     , _needsRefresh(refresh)
     , _data(nullptr) // keep data access consistent across all types of buses
+    , _front(nullptr)
+    , _frameHash(0)
+    , _lastSent(0)
+    , _dirtyStart(UINT16_MAX)
+    , _dirtyEnd(0)
+    , _frameStart(UINT16_MAX)
+    , _frameEnd(0)
+    , _powerSum(0)
+    , _powerModel(0)
     {
-      _autoWhiteMode = Bus::hasWhite(type) ? aw : RGBW_MODE_MANUAL_ONLY;
+      _hasRgb   = Bus::hasRGB(type);
+      _hasWhite = Bus::hasWhite(type);
+      _autoWhiteMode = _hasWhite ? aw : RGBW_MODE_MANUAL_ONLY;
     };
 
     virtual ~Bus() {} //throw the bus under the bus
 
     virtual void     show() = 0;
+    virtual bool     latch()                     { return false; } // copy frame for show() from another task, false if not supported
     virtual bool     canShow()                   { return true; }
     virtual void     setStatusPixel(uint32_t c)  {}
     virtual void     setPixelColor(uint16_t pix, uint32_t c) = 0;
@@ -140,6 +172,8 @@ class Bus {
     inline  bool     isReversed()                { return _reversed; }
     inline  bool     isOffRefreshRequired()      { return _needsRefresh; }
             bool     containsPixel(uint16_t pix) { return pix >= _start && pix < _start+_len; }
+            uint32_t getPowerSum(bool ws2815);
+    inline  void     setDirty()                  { _dirtyStart = 0; _dirtyEnd = _len; _powerModel = 0; } // all pixels need sending
 
     virtual bool hasRGB(void) { return Bus::hasRGB(_type); }
     static  bool hasRGB(uint8_t type) {
@@ -159,9 +193,7 @@ class Bus {
           type == TYPE_ANALOG_2CH    || type == TYPE_ANALOG_5CH) return true;
       return false;
     }
-    static void setCCT(uint16_t cct) {
-      _cct = cct;
-    }
+    static void setCCT(int16_t cct);
     static void setCCTBlend(uint8_t b) {
       if (b > 100) b = 100;
       _cctBlend = (b * 127) / 100;
@@ -174,6 +206,8 @@ class Bus {
     inline        uint8_t getAutoWhiteMode()          { return _autoWhiteMode; }
     inline static void    setGlobalAWMode(uint8_t m)  { if (m < 5) _gAWM = m; else _gAWM = AW_GLOBAL_DISABLED; }
     inline static uint8_t getGlobalAWMode()           { return _gAWM; }
+    inline static void     setKeepAlive(uint16_t ms)  { _keepAlive = ms; }
+    inline static uint16_t getKeepAlive()             { return _keepAlive; }
 
   protected:
     uint8_t  _type;
@@ -183,15 +217,36 @@ class Bus {
     bool     _reversed;
     bool     _valid;
     bool     _needsRefresh;
+    bool     _hasRgb;   // type capabilities, resolved once instead of per pixel
+    bool     _hasWhite;
     uint8_t  _autoWhiteMode;
     uint8_t  *_data;
+    uint8_t  *_front; // copy of _data made by latch(), transmitted by show() instead of _data
+    uint32_t _frameHash; // hash of last sent frame
+    unsigned long _lastSent;
+    uint16_t _dirtyStart; // pixels changed since the last frame was taken: _dirtyStart ... _dirtyEnd-1
+    uint16_t _dirtyEnd;
+    uint16_t _frameStart; // pixels changed in the frame being shown (taken by show() or latch())
+    uint16_t _frameEnd;
+    uint32_t _powerSum;   // cached result of getPowerSum()
+    uint8_t  _powerModel; // power model _powerSum was calculated with, 0 if pixels changed since
+    static uint16_t _keepAlive;
     static uint8_t _gAWM;
     static int16_t _cct;
     static uint8_t _cctBlend;
+    static uint8_t _cctRGB[3]; // white balance correction for _cct (if Kelvin)
 
     uint32_t autoWhiteCalc(uint32_t c);
+    static uint32_t colorBalance(uint32_t c);
     uint8_t *allocData(size_t size = 1);
-    void     freeData() { if (_data != nullptr) free(_data); _data = nullptr; }
+    void     freeData() { if (_data != nullptr) free(_data); _data = nullptr; if (_front != nullptr) free(_front); _front = nullptr; }
+    bool     latchData(size_t size);
+    bool     frameChanged(const uint8_t *data, size_t size);
+    bool     frameRange(uint16_t &first, uint16_t &last, bool refresh, bool partial = true);
+    inline void markDirty(uint16_t pix) { if (pix < _dirtyStart) _dirtyStart = pix; if (pix >= _dirtyEnd) _dirtyEnd = pix + 1; _powerModel = 0; }
+    inline void takeDirty() { _frameStart = _dirtyStart; _frameEnd = _dirtyEnd; _dirtyStart = UINT16_MAX; _dirtyEnd = 0; }
+    inline void forceSend() { _lastSent = millis() - _keepAlive; _frameHash = ~_frameHash; }
+    inline const uint8_t *showData() const { return _front ? _front : _data; }
 };
 
 
@@ -201,11 +256,13 @@ class BusDigital : public Bus {
     ~BusDigital() { cleanup(); }
 
     void show();
+    bool latch();
     bool canShow();
     void setBrightness(uint8_t b);
     void setStatusPixel(uint32_t c);
     void setPixelColor(uint16_t pix, uint32_t c);
     void setColorOrder(uint8_t colorOrder);
+    void updateColorOrder(); // call when color order map changes
     uint32_t getPixelColor(uint16_t pix);
     uint8_t  getColorOrder() { return _colorOrder; }
     uint8_t  getPins(uint8_t* pinArray);
@@ -221,8 +278,25 @@ class BusDigital : public Bus {
     uint8_t _iType;
     uint16_t _frequencykHz;
     void * _busPtr;
+    const PolyBusFunctions *_fns; // bus type specific implementation, bound at creation
     const ColorOrderMap &_colorOrderMap;
     bool _buffering; // temporary until we figure out why comparison "_data != nullptr" causes severe FPS drop
+    uint8_t _numColorOrderRuns; // 1 if no color order map entry covers this bus
+    ColorOrderRun _colorOrderRuns[2*WLED_MAX_COLOR_ORDER_MAPPINGS+1]; // sorted by start, first starts at _start
+    uint8_t _paintedBri;   // brightness the NeoPixelBus buffer is scaled with (_bri is applied in show())
+    bool _consistent;      // NeoPixelBus editing buffer still holds the last frame, so only changed pixels need converting
+
+    void applyBrightness();
+
+    // binary search for the run containing pix
+    inline uint8_t pixelColorOrder(uint16_t pix) const {
+      uint8_t lo = 0, hi = _numColorOrderRuns;
+      while (hi - lo > 1) {
+        uint8_t mid = (lo + hi) >> 1;
+        if (_colorOrderRuns[mid].start <= pix) lo = mid; else hi = mid;
+      }
+      return _colorOrderRuns[lo].colorOrder;
+    }
 
     inline uint32_t restoreColorLossy(uint32_t c, uint8_t restoreBri) {
       if (restoreBri < 255) {
@@ -290,6 +364,7 @@ class BusNetwork : public Bus {
     uint32_t getPixelColor(uint16_t pix);
     uint8_t  getPins(uint8_t* pinArray);
     void show();
+    bool latch() { return _valid && latchData(_len * _UDPchannels); }
     void cleanup();
 
   private:
@@ -298,12 +373,17 @@ class BusNetwork : public Bus {
     uint8_t   _UDPchannels;
     bool      _rgbw;
     bool      _broadcastLock;
+    uint8_t   _sentBri; // brightness the receiver got the last frame with
 };
 
 
 class BusManager {
   public:
-    BusManager() : numBusses(0) {};
+    BusManager() : numBusses(0) {
+      #ifdef WLED_ASYNC_SHOW
+      _showTask = nullptr;
+      #endif
+    };
 
     //utility to get the approx. memory usage of a given BusConfig
     static uint32_t memUsage(BusConfig &bc);
@@ -319,6 +399,7 @@ class BusManager {
     void setPixelColor(uint16_t pix, uint32_t c);
     void setBrightness(uint8_t b);
     void setSegmentCCT(int16_t cct, bool allowWBCorrection = false);
+    void setDirty(); // mark all pixels changed, e.g. if they were set from multiple tasks
     uint32_t getPixelColor(uint16_t pix);
 
     Bus* getBus(uint8_t busNr);
@@ -327,7 +408,7 @@ class BusManager {
     uint16_t getTotalLength();
     inline uint8_t getNumBusses() const { return numBusses; }
 
-    inline void                 updateColorOrderMap(const ColorOrderMap &com) { memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap)); }
+    void                        updateColorOrderMap(const ColorOrderMap &com);
     inline const ColorOrderMap& getColorOrderMap() const { return colorOrderMap; }
 
   private:
@@ -335,6 +416,17 @@ class BusManager {
     Bus* busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
     ColorOrderMap colorOrderMap;
 
+    #ifdef WLED_ASYNC_SHOW
+    TaskHandle_t      _showTask;
+    SemaphoreHandle_t _showStart, _showDone;
+    uint32_t          _latched; // bit set for buses that are sent by show task
+    static void showTask(void *parameter);
+    // fence: wait until show task is done with the previous frame
+    inline void waitForShow() { if (_showTask) { xSemaphoreTake(_showDone, portMAX_DELAY); xSemaphoreGive(_showDone); } }
+    #else
+    inline void waitForShow() {}
+    #endif
+
     inline uint8_t getNumVirtualBusses() {
       int j = 0;
       for (int i=0; i<numBusses; i++) if (busses[i]->getType() >= TYPE_NET_DDP_RGB && busses[i]->getType() < 96) j++;
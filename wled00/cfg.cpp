@@ -90,6 +90,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   Bus::setCCTBlend(strip.cctBlending);
   strip.setTargetFps(hw_led["fps"]); //NOP if 0, default 42 FPS
   CJSON(useGlobalLedBuffer, hw_led[F("ld")]);
+  Bus::setKeepAlive(hw_led[F("ka")] | Bus::getKeepAlive());
 
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
@@ -355,6 +356,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     gammaCorrectBri = false;
     gammaCorrectCol = false;
   }
+  strip.invalidateCustomPaletteCache(); // custom palettes are gamma corrected when loaded
 
   JsonObject light_tr = light["tr"];
   CJSON(fadeTransition, light_tr["mode"]);
@@ -545,6 +547,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     }
     it++;
   }
+  invalidateTimers();
 
   JsonObject ota = doc["ota"];
   const char* pwd = ota["psk"]; //normally not present due to security
@@ -573,6 +576,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   }
 
   CJSON(e131ProxyUniverse, dmx[F("e131proxy")]);
+  invalidateDMXMap(); // fixture map may have changed
   #endif
 
   DEBUG_PRINTLN(F("Starting usermod config."));
@@ -720,6 +724,7 @@ void serializeConfig() {
   hw_led["fps"] = strip.getTargetFps();
   hw_led[F("rgbwm")] = Bus::getGlobalAWMode(); // global auto white mode override
   hw_led[F("ld")] = useGlobalLedBuffer;
+  hw_led[F("ka")] = Bus::getKeepAlive();
 
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
@@ -7,6 +7,17 @@
 
 #define GRADIENT_PALETTE_COUNT 58
 
+// custom palettes use IDs 255 downwards, all IDs not used by built-in palettes are available
+#define WLED_MAX_CUSTOM_PALETTES (256 - 13 - GRADIENT_PALETTE_COUNT)
+// number of (most recently used) custom palettes kept in RAM, others are read from the palette bank when needed
+#ifndef WLED_CUSTOM_PALETTE_CACHE
+  #ifdef ESP8266
+    #define WLED_CUSTOM_PALETTE_CACHE 2
+  #else
+    #define WLED_CUSTOM_PALETTE_CACHE 4
+  #endif
+#endif
+
 //Defaults
 #define DEFAULT_CLIENT_SSID "Your_Network"
 #define DEFAULT_AP_SSID     "WLED-AP"
@@ -23,6 +34,12 @@
   #endif
 #endif
 
+// max. time (us) per main loop iteration for usermods with a loop interval (see Usermod::getLoopInterval())
+// usermods that are due but don't fit into the budget are run in one of the next iterations
+#ifndef WLED_USERMOD_LOOP_BUDGET
+  #define WLED_USERMOD_LOOP_BUDGET 2000
+#endif
+
 #ifndef WLED_MAX_BUSSES
   #ifdef ESP8266
     #define WLED_MAX_BUSSES 3
@@ -318,6 +335,10 @@
 #define SEG_OPTION_MIRROR_Y       7
 #define SEG_OPTION_TRANSPOSED     8
 
+// compact fixed-layout segment state (Segment::saveState()), also the segment record of UDP sync packets
+#define SEG_STATE_SIZE         36
+#define SEG_STATE_VERSION      1
+
 //Segment differs return byte
 #define SEG_DIFFERS_BRI        0x01 // opacity
 #define SEG_DIFFERS_OPT        0x02 // all segment options except: selected, reset & transitional
@@ -326,9 +347,36 @@
 #define SEG_DIFFERS_BOUNDS     0x10 // segment start/stop bounds
 #define SEG_DIFFERS_GSO        0x20 // grouping, spacing & offset
 #define SEG_DIFFERS_SEL        0x80 // selected
+#define SEG_DIFFERS_ALL        0x7F // everything except selection
+
+// number of presets kept pre-parsed in RAM
+#ifndef WLED_PRESET_CACHE_SIZE
+  #ifdef ESP8266
+    #define WLED_PRESET_CACHE_SIZE 2
+  #else
+    #define WLED_PRESET_CACHE_SIZE 8
+  #endif
+#endif
+// total size of presets kept in RAM (MessagePack bytes), larger presets are not cached
+#ifndef WLED_PRESET_CACHE_BYTES
+  #ifdef ESP8266
+    #define WLED_PRESET_CACHE_BYTES 2048
+  #else
+    #define WLED_PRESET_CACHE_BYTES 8192
+  #endif
+#endif
 
 //Playlist option byte
 #define PL_OPTION_SHUFFLE      0x01
+#define PL_OPTION_SYNC         0x02 // entry position follows (NTP/UDP synced) wall clock
+
+#ifndef WLED_MAX_PLAYLIST_ENTRIES
+  #ifdef ESP8266
+    #define WLED_MAX_PLAYLIST_ENTRIES 255
+  #else
+    #define WLED_MAX_PLAYLIST_ENTRIES 1000
+  #endif
+#endif
 
 // Segment capability byte
 #define SEG_CAPABILITY_RGB     0x01
@@ -12,60 +12,121 @@
 
 #ifdef WLED_ENABLE_DMX
 
+#define DMX_UNIVERSE_SIZE 512
+#ifndef WLED_DMX_REFRESH_MS
+  #define WLED_DMX_REFRESH_MS 250 // resend unchanged universe at least this often so fixtures do not time out
+#endif
+
+/*
+ * Fixture channel map is compiled from DMXFixtureMap when settings (or LED count) change:
+ * constant channels (0, 255) are written into the universe once, only color and shutter channels
+ * are updated, and only after a new frame has been shown. The DMX bus is updated only if a channel changed
+ * (or WLED_DMX_REFRESH_MS elapsed).
+ */
+typedef struct DMXColorOp {
+  uint8_t offset; // channel offset within fixture
+  uint8_t shift;  // position of color component in 32 bit pixel color
+} dmx_color_op_t;
+
+static dmx_color_op_t dmxColorOps[15];
+static uint8_t  dmxColorOpCount = 0;
+static uint8_t  dmxShutterOps[15];       // channel offsets of shutter channels
+static uint8_t  dmxShutterOpCount = 0;
+static bool     dmxScaleColors = true;   // no shutter channel: colors are scaled by brightness
+static uint16_t dmxFixtureCount = 0;     // fixtures (partially) within universe
+static uint16_t dmxMapLength = 0;        // LED count the map was compiled for
+static bool     dmxMapValid = false;
+
+static uint8_t  dmxUniverse[DMX_UNIVERSE_SIZE+1]; // copy of sent universe, [0] unused as channels start at 1
+static bool     dmxDirty = true;
+static unsigned long dmxLastFrame = 0;   // strip.getLastShow() of last processed frame
+static unsigned long dmxLastSend = 0;
+
+static inline void setDMXChannel(unsigned addr, uint8_t value) {
+  if (dmxUniverse[addr] == value) return;
+  dmxUniverse[addr] = value;
+  dmx.write(addr, value);
+  dmxDirty = true;
+}
+
+static void compileDMXMap() {
+  uint8_t channels = MIN(DMXChannels, 15);
+  dmxColorOpCount = 0;
+  dmxShutterOpCount = 0;
+  dmxScaleColors = true;
+  for (unsigned j = 0; j < channels; j++) {
+    switch (DMXFixtureMap[j]) {
+      case 1: dmxColorOps[dmxColorOpCount++] = {uint8_t(j), 16}; break; // Red
+      case 2: dmxColorOps[dmxColorOpCount++] = {uint8_t(j),  8}; break; // Green
+      case 3: dmxColorOps[dmxColorOpCount++] = {uint8_t(j),  0}; break; // Blue
+      case 4: dmxColorOps[dmxColorOpCount++] = {uint8_t(j), 24}; break; // White
+      case 5: dmxShutterOps[dmxShutterOpCount++] = j; dmxScaleColors = false; break; // Shutter channel. Controls the brightness.
+      default: break; // 0 or 255, constant
+    }
+  }
+
+  // constant channels, everything not mapped is 0
+  memset(dmxUniverse, 0, sizeof(dmxUniverse));
+  dmxMapLength = strip.getLengthTotal();
+  dmxFixtureCount = 0;
+  for (unsigned i = DMXStartLED; i < dmxMapLength; i++) { // uses the amount of LEDs as fixture count
+    unsigned fixtureStart = DMXStart + (DMXGap * (i - DMXStartLED));
+    if (fixtureStart > DMX_UNIVERSE_SIZE) break;
+    dmxFixtureCount++;
+    for (unsigned j = 0; j < channels && fixtureStart + j <= DMX_UNIVERSE_SIZE; j++) {
+      if (DMXFixtureMap[j] == 6) dmxUniverse[fixtureStart + j] = 255; // Sets this channel to 255. Like 0, but more wholesome.
+    }
+  }
+  for (unsigned addr = 1; addr <= DMX_UNIVERSE_SIZE; addr++) dmx.write(addr, dmxUniverse[addr]);
+
+  dmxLastFrame = strip.getLastShow() - 1; // force update of color channels
+  dmxDirty = true;
+  dmxMapValid = true;
+  DEBUG_PRINTF("DMX map: %u fixtures, %u color channels each.\n", dmxFixtureCount, dmxColorOpCount);
+}
+
+// call when DMX or LED settings change
+void invalidateDMXMap() {
+  dmxMapValid = false;
+}
+
 void handleDMX()
 {
-  // don't act, when in DMX Proxy mode
-  if (e131ProxyUniverse != 0) return;
-
-  uint8_t brightness = strip.getBrightness();
-
-  bool calc_brightness = true;
-
-   // check if no shutter channel is set
-   for (byte i = 0; i < DMXChannels; i++)
-   {
-     if (DMXFixtureMap[i] == 5) calc_brightness = false;
-   }
-
-  uint16_t len = strip.getLengthTotal();
-  for (int i = DMXStartLED; i < len; i++) {        // uses the amount of LEDs as fixture count
-
-    uint32_t in = strip.getPixelColor(i);     // get the colors for the individual fixtures as suggested by Aircoookie in issue #462
-    byte w = W(in);
-    byte r = R(in);
-    byte g = G(in);
-    byte b = B(in);
-
-    int DMXFixtureStart = DMXStart + (DMXGap * (i - DMXStartLED));
-    for (int j = 0; j < DMXChannels; j++) {
-      int DMXAddr = DMXFixtureStart + j;
-      switch (DMXFixtureMap[j]) {
-        case 0:        // Set this channel to 0. Good way to tell strobe- and fade-functions to fuck right off.
-          dmx.write(DMXAddr, 0);
-          break;
-        case 1:        // Red
-          dmx.write(DMXAddr, calc_brightness ? (r * brightness) / 255 : r);
-          break;
-        case 2:        // Green
-          dmx.write(DMXAddr, calc_brightness ? (g * brightness) / 255 : g);
-          break;
-        case 3:        // Blue
-          dmx.write(DMXAddr, calc_brightness ? (b * brightness) / 255 : b);
-          break;
-        case 4:        // White
-          dmx.write(DMXAddr, calc_brightness ? (w * brightness) / 255 : w);
-          break;
-        case 5:        // Shutter channel. Controls the brightness.
-          dmx.write(DMXAddr, brightness);
-          break;
-        case 6:        // Sets this channel to 255. Like 0, but more wholesome.
-          dmx.write(DMXAddr, 255);
-          break;
+  // don't act, when in DMX Proxy mode (E1.31 data is written to the bus directly)
+  if (e131ProxyUniverse != 0) {
+    dmxMapValid = false;
+    return;
+  }
+
+  if (!dmxMapValid || dmxMapLength != strip.getLengthTotal()) compileDMXMap();
+
+  // only a newly shown frame can change the output
+  if (strip.getLastShow() != dmxLastFrame) {
+    dmxLastFrame = strip.getLastShow();
+    uint8_t brightness = strip.getBrightness();
+
+    for (unsigned f = 0; f < dmxFixtureCount; f++) {
+      uint32_t in = strip.getPixelColor(DMXStartLED + f); // get the colors for the individual fixtures as suggested by Aircoookie in issue #462
+      unsigned fixtureStart = DMXStart + (DMXGap * f);
+      for (unsigned o = 0; o < dmxColorOpCount; o++) {
+        unsigned addr = fixtureStart + dmxColorOps[o].offset;
+        if (addr > DMX_UNIVERSE_SIZE) break; // offsets are ascending
+        uint8_t value = in >> dmxColorOps[o].shift;
+        setDMXChannel(addr, dmxScaleColors ? (value * brightness) / 255 : value);
+      }
+      for (unsigned o = 0; o < dmxShutterOpCount; o++) {
+        unsigned addr = fixtureStart + dmxShutterOps[o];
+        if (addr > DMX_UNIVERSE_SIZE) break;
+        setDMXChannel(addr, brightness);
       }
     }
   }
 
-  dmx.update();        // update the DMX bus
+  if (dmxDirty || millis() - dmxLastSend > WLED_DMX_REFRESH_MS) {
+    dmx.update();        // update the DMX bus
+    dmxDirty = false;
+    dmxLastSend = millis();
+  }
 }
 
 void initDMX() {
@@ -74,9 +135,11 @@ void initDMX() {
  #else
   dmx.initWrite(512);  // initialize with bus length
  #endif
+  dmxMapValid = false;
 }
 
 #else
 void handleDMX() {}
 void initDMX() {}
+void invalidateDMXMap() {}
 #endif
@@ -80,6 +80,7 @@ void setRandomColor(byte* rgb);
 //dmx.cpp
 void initDMX();
 void handleDMX();
+void invalidateDMXMap();
 
 //e131.cpp
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
@@ -192,6 +193,7 @@ bool checkCountdown();
 void setCountdown();
 byte weekdayMondayFirst();
 void checkTimers();
+void invalidateTimers();
 void calculateSunriseAndSunset();
 void setTimeFromAPI(uint32_t timein);
 
@@ -211,6 +213,10 @@ void serializePlaylist(JsonObject obj);
 void initPresetsFile();
 void handlePresets();
 bool applyPreset(byte index, byte callMode = CALL_MODE_DIRECT_CHANGE);
+bool preloadPreset(byte index);
+void invalidatePresetCache(byte index = 0);
+void presetsFileChanged();
+void serializePresetCacheInfo(JsonObject info);
 void applyPresetWithFallback(uint8_t presetID, uint8_t callMode, uint8_t effectID = 0, uint8_t paletteID = 0);
 inline bool applyTemporaryPreset() {return applyPreset(255);};
 void savePreset(byte index, const char* pname = nullptr, JsonObject saveobj = JsonObject());
@@ -228,11 +234,12 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=tru
 
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false, uint16_t start=0);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixels(uint16_t start, uint16_t count, const byte *data, uint8_t stride = 3);
 void refreshNodeList();
 void sendSysInfoUDP();
 
@@ -297,12 +304,26 @@ class Usermod {
     virtual void onUpdateBegin(bool) {}                                      // fired prior to and after unsuccessful firmware update
     virtual void onStateChange(uint8_t mode) {}                              // fired upon WLED state change
     virtual uint16_t getId() {return USERMOD_ID_UNSPECIFIED;}
+    virtual uint16_t getLoopInterval() { return 0; }                          // desired time between loop() calls in ms, 0 = every main loop iteration
 };
 
 class UsermodManager {
   private:
+    // loop() scheduling and runtime statistics (per usermod)
+    typedef struct UsermodStats {
+      unsigned long lastRun;  // millis() of last loop() call
+      uint32_t minTime;       // shortest loop() runtime (us)
+      uint32_t maxTime;       // longest loop() runtime (us)
+      uint32_t avgTime;       // average loop() runtime (us), smoothed
+      uint32_t runs;          // number of loop() calls
+    } um_stats_t;
+
     Usermod* ums[WLED_MAX_USERMODS];
+    um_stats_t stats[WLED_MAX_USERMODS];
     byte numMods = 0;
+    byte nextScheduled = 0;   // round-robin start for usermods with loop interval
+
+    void runLoop(byte i);
 
   public:
     void loop();
@@ -324,6 +345,7 @@ class UsermodManager {
     bool add(Usermod* um);
     Usermod* lookup(uint16_t mod_id);
     byte getModCount() {return numMods;};
+    void addStatsToJsonInfo(JsonObject& obj);
 };
 
 //usermods_list.cpp
@@ -34,8 +34,8 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   //DEBUG_PRINTLN("-- JSON deserialize segment.");
   Segment& seg = strip.getSegment(id);
   //DEBUG_PRINTF("--  Original segment: %p\n", &seg);
-  Segment prev = seg; //make a backup so we can tell if something changed
-  //DEBUG_PRINTF("--  Duplicate segment: %p\n", &prev);
+  byte prev[SEG_STATE_SIZE]; //make a compact backup so we can tell if something changed
+  seg.saveState(prev);
 
   uint16_t start = elem["start"] | seg.start;
   if (stop < 0) {
@@ -291,7 +291,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
     strip.trigger(); // force segment update
   }
   // send UDP/WS if segment options changed (except selection; will also deselect current preset)
-  if (seg.differs(prev) & 0x7F) stateChanged = true;
+  if (seg.differs(prev) & SEG_DIFFERS_ALL) stateChanged = true;
 
   return true;
 }
@@ -459,9 +459,9 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   }
 
   if (root.containsKey(F("rmcpal")) && root[F("rmcpal")].as<bool>()) {
-    if (strip.customPalettes.size()) {
+    if (strip.getCustomPaletteCount()) {
       char fileName[32];
-      sprintf_P(fileName, PSTR("/palette%d.json"), strip.customPalettes.size()-1);
+      sprintf_P(fileName, PSTR("/palette%d.json"), strip.getCustomPaletteCount()-1);
       if (WLED_FS.exists(fileName)) WLED_FS.remove(fileName);
       strip.loadCustomPalettes();
     }
@@ -540,6 +540,11 @@ void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, b
   root["o3"]  = seg.check3;
   root["si"]  = seg.soundSim;
   root["m12"] = seg.map1D2D;
+  if (!forPreset) {
+    root[F("fxt")] = seg.fxTime;   // effect run time (us)
+    root[F("dgr")] = seg.slowdown; // effect update rate reduced to 1/2^dgr because of CPU budget
+    if (seg.outOfMem) root[F("oom")] = true; // effect data refused, effect runs degraded or falls back to solid
+  }
 }
 
 void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool selectedSegmentsOnly)
@@ -612,6 +617,8 @@ void serializeInfo(JsonObject root)
   leds[F("count")] = strip.getLengthTotal();
   leds[F("pwr")] = strip.currentMilliamps;
   leds["fps"] = strip.getFps();
+  leds[F("miss")] = strip.getMissedDeadlines();
+  leds[F("late")] = strip.getAvgLateness();
   leds[F("maxpwr")] = (strip.currentMilliamps)? strip.ablMilliampsMax : 0;
   leds[F("maxseg")] = strip.getMaxSegments();
   //leds[F("actseg")] = strip.getActiveSegmentsNum();
@@ -685,7 +692,7 @@ void serializeInfo(JsonObject root)
 
   root[F("fxcount")] = strip.getModeCount();
   root[F("palcount")] = strip.getPaletteCount();
-  root[F("cpalcount")] = strip.customPalettes.size(); //number of custom palettes
+  root[F("cpalcount")] = strip.getCustomPaletteCount(); //number of custom palettes
 
   JsonArray ledmaps = root.createNestedArray(F("maps"));
   for (size_t i=0; i<WLED_MAX_LEDMAPS; i++) {
@@ -709,6 +716,7 @@ void serializeInfo(JsonObject root)
   fs_info["u"] = fsBytesUsed / 1000;
   fs_info["t"] = fsBytesTotal / 1000;
   fs_info[F("pmt")] = presetsModifiedTime;
+  serializePresetCacheInfo(fs_info.createNestedObject(F("pc")));
 
   root[F("ndc")] = nodeListEnabled ? (int)Nodes.size() : -1;
 
@@ -750,6 +758,7 @@ void serializeInfo(JsonObject root)
   root[F("time")] = time;
 
   usermods.addToJsonInfo(root);
+  usermods.addStatsToJsonInfo(root);
 
   uint16_t os = 0;
   #ifdef WLED_DEBUG
@@ -844,7 +853,7 @@ void serializePalettes(JsonObject root, int page)
   #endif
 
   int palettesCount = strip.getPaletteCount();
-  int customPalettes = strip.customPalettes.size();
+  int customPalettes = strip.getCustomPaletteCount();
 
   int maxPage = (palettesCount + customPalettes -1) / itemPerPage;
   if (page > maxPage) page = maxPage;
@@ -924,7 +933,9 @@ void serializePalettes(JsonObject root, int page)
       default:
         {
         if (i>=palettesCount) {
-          setPaletteColors(curPalette, strip.customPalettes[i - palettesCount]);
+          CRGBPalette16 customPalette(CRGB::Black);
+          strip.loadCustomPalette(i - palettesCount, customPalette, false); // not on loop task, bypass cache
+          setPaletteColors(curPalette, customPalette);
         } else {
           memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[i - 13])), 72);
           setPaletteColors(curPalette, tcp);
@@ -1,6 +1,7 @@
 #include "src/dependencies/timezone/Timezone.h"
 #include "wled.h"
 #include "fcn_declare.h"
+#include <algorithm>
 
 // on esp8266, building with `-D WLED_USE_UNREAL_MATH` saves around 7Kb flash and 1KB RAM
 //  warning: causes errors in sunset calculations, see #3400
@@ -173,6 +174,7 @@ void updateTimezone() {
   tzCurrent = currentTimezone;
 
   tz = new Timezone(tcrDaylight, tcrStandard);
+  invalidateTimers();
 }
 
 void handleTime() {
@@ -389,59 +391,91 @@ bool isTodayInDateRange(byte monthStart, byte dayStart, byte monthEnd, byte dayE
 	return (m == monthStart && d >= dayStart && d <= dayEnd); //just the designated days this month
 }
 
+/*
+ * Timers are compiled into a sorted list of today's trigger times (minute of local day) when the date,
+ * timer settings, timezone or sunrise/sunset change; each new minute only the next list entries are checked.
+ */
+typedef struct TimerEvent {
+  uint16_t minute;  // minute of local day
+  uint8_t  preset;
+} timer_event_t;
+
+static std::vector<timer_event_t> timerEvents;
+static size_t   timerEventNext = 0;     // index of next event in timerEvents
+static uint16_t timerLastMinute = 0;    // minute of day of last check
+static uint32_t timerEventsDay = 0;     // local day the list was compiled for (0: needs compiling)
+
+// call when timer settings change
+void invalidateTimers()
+{
+  timerEventsDay = 0;
+}
+
+static void addTimerEvent(time_t t, uint8_t preset)
+{
+  timer_event_t ev = {uint16_t(hour(t)*60 + minute(t)), preset};
+  timerEvents.push_back(ev);
+}
+
+static void compileTimers()
+{
+  timerEvents.clear();
+  byte wd = weekdayMondayFirst();
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    if (timerMacro[i] == 0
+        || !(timerWeekday[i] & 0x01) //timer is disabled
+        || !((timerWeekday[i] >> wd) & 0x01) //timer should not activate at current day of week
+        || timerMinutes[i] < 0 || timerMinutes[i] > 59 || timerHours[i] > 24
+        || !isTodayInDateRange(((timerMonth[i] >> 4) & 0x0F), timerDay[i], timerMonth[i] & 0x0F, timerDayEnd[i])
+       ) continue;
+    if (timerHours[i] == 24) { //if hour is set to 24, activate every hour
+      for (int h = 0; h < 24; h++) addTimerEvent(h*SECS_PER_HOUR + timerMinutes[i]*60, timerMacro[i]);
+    } else {
+      addTimerEvent(timerHours[i]*SECS_PER_HOUR + timerMinutes[i]*60, timerMacro[i]);
+    }
+  }
+  // sunrise (8) and sunset (9) macros
+  for (uint8_t i = 8; i < 10; i++)
+  {
+    time_t sun = (i == 8) ? sunrise : sunset;
+    if (!sun || timerMacro[i] == 0 || !(timerWeekday[i] & 0x01) || !((timerWeekday[i] >> wd) & 0x01)) continue;
+    time_t tmp = sun + timerMinutes[i]*60;  // NOTE: may not be ok
+    DEBUG_PRINTF("Trigger time: %02d:%02d\n", hour(tmp), minute(tmp));
+    addTimerEvent(tmp, timerMacro[i]);
+  }
+  // keep settings order for events at the same time (last applied preset wins, as before)
+  std::stable_sort(timerEvents.begin(), timerEvents.end(), [](const timer_event_t &a, const timer_event_t &b) { return a.minute < b.minute; });
+
+  timerLastMinute = hour(localTime)*60 + minute(localTime);
+  timerEventNext = 0;
+  while (timerEventNext < timerEvents.size() && timerEvents[timerEventNext].minute < timerLastMinute) timerEventNext++;
+  timerEventsDay = elapsedDays(localTime) + 1;
+  DEBUG_PRINTF("Timers compiled: %u events today.\n", timerEvents.size());
+}
+
 void checkTimers()
 {
   if (lastTimerMinute != minute(localTime)) //only check once a new minute begins
   {
     lastTimerMinute = minute(localTime);
 
-    // re-calculate sunrise and sunset just after midnight
-    if (!hour(localTime) && minute(localTime)==1) calculateSunriseAndSunset();
+    if (timerEventsDay != elapsedDays(localTime) + 1) {
+      // re-calculate sunrise and sunset when a new day begins
+      if (timerEventsDay) calculateSunriseAndSunset();
+      compileTimers();
+    }
 
     DEBUG_PRINTF("Local time: %02d:%02d\n", hour(localTime), minute(localTime));
-    for (uint8_t i = 0; i < 8; i++)
-    {
-      if (timerMacro[i] != 0
-          && (timerWeekday[i] & 0x01) //timer is enabled
-          && (timerHours[i] == hour(localTime) || timerHours[i] == 24) //if hour is set to 24, activate every hour
-          && timerMinutes[i] == minute(localTime)
-          && ((timerWeekday[i] >> weekdayMondayFirst()) & 0x01) //timer should activate at current day of week
-          && isTodayInDateRange(((timerMonth[i] >> 4) & 0x0F), timerDay[i], timerMonth[i] & 0x0F, timerDayEnd[i])
-         )
-      {
-        unloadPlaylist();
-        applyPreset(timerMacro[i]);
-      }
-    }
-    // sunrise macro
-    if (sunrise) {
-      time_t tmp = sunrise + timerMinutes[8]*60;  // NOTE: may not be ok
-      DEBUG_PRINTF("Trigger time: %02d:%02d\n", hour(tmp), minute(tmp));
-      if (timerMacro[8] != 0
-          && hour(tmp) == hour(localTime)
-          && minute(tmp) == minute(localTime)
-          && (timerWeekday[8] & 0x01) //timer is enabled
-          && ((timerWeekday[8] >> weekdayMondayFirst()) & 0x01)) //timer should activate at current day of week
-      {
-        unloadPlaylist();
-        applyPreset(timerMacro[8]);
-        DEBUG_PRINTF("Sunrise macro %d triggered.",timerMacro[8]);
-      }
-    }
-    // sunset macro
-    if (sunset) {
-      time_t tmp = sunset + timerMinutes[9]*60;  // NOTE: may not be ok
-      DEBUG_PRINTF("Trigger time: %02d:%02d\n", hour(tmp), minute(tmp));
-      if (timerMacro[9] != 0
-          && hour(tmp) == hour(localTime)
-          && minute(tmp) == minute(localTime)
-          && (timerWeekday[9] & 0x01) //timer is enabled
-          && ((timerWeekday[9] >> weekdayMondayFirst()) & 0x01)) //timer should activate at current day of week
-      {
-        unloadPlaylist();
-        applyPreset(timerMacro[9]);
-        DEBUG_PRINTF("Sunset macro %d triggered.",timerMacro[9]);
-      }
+    uint16_t now = hour(localTime)*60 + minute(localTime);
+    if (now < timerLastMinute) timerEventNext = 0; // time was set back
+    timerLastMinute = now;
+    while (timerEventNext < timerEvents.size() && timerEvents[timerEventNext].minute < now) timerEventNext++;
+    while (timerEventNext < timerEvents.size() && timerEvents[timerEventNext].minute == now) {
+      unloadPlaylist();
+      applyPreset(timerEvents[timerEventNext].preset);
+      DEBUG_PRINTF("Timer macro %d triggered.\n", timerEvents[timerEventNext].preset);
+      timerEventNext++;
     }
   }
 }
@@ -551,6 +585,7 @@ void calculateSunriseAndSunset() {
     } else {
       sunset = 0;
     }
+    invalidateTimers();
   }
 }
 
@@ -2,22 +2,32 @@
 
 /*
  * Handles playlists, timed sequences of presets
+ *
+ * Entries are cues on a timeline: each cue is due exactly one entry duration after the previous cue
+ * (not after the moment it was handled), so timing does not drift over long shows.
+ * A cue fires on the frame closest to its due time and the next entry's preset is read into RAM in advance.
+ * With "sync" the position within the playlist is derived from the (NTP/UDP synced) wall clock,
+ * so all nodes running the same playlist switch entries on the same frame.
  */
 
 typedef struct PlaylistEntry {
-  uint8_t preset; //ID of the preset to apply
-  uint16_t dur;   //Duration of the entry (in tenths of seconds)
-  uint16_t tr;    //Duration of the transition TO this entry (in tenths of seconds)
+  uint8_t  preset; //ID of the preset to apply
+  uint32_t dur;    //Duration of the entry (in milliseconds)
+  uint16_t tr;     //Duration of the transition TO this entry (in tenths of seconds)
 } ple;
 
 byte           playlistRepeat = 1;        //how many times to repeat the playlist (0 = infinitely)
 byte           playlistEndPreset = 0;     //what preset to apply after playlist end (0 = stay on last preset)
-byte           playlistOptions = 0;       //bit 0: shuffle playlist after each iteration. bits 1-7 TBD
+byte           playlistOptions = 0;       //bit 0: shuffle playlist after each iteration. bit 1: sync to wall clock. bits 2-7 TBD
 
 PlaylistEntry *playlistEntries = nullptr;
-byte           playlistLen;               //number of playlist entries
-int8_t         playlistIndex = -1;
-uint16_t       playlistEntryDur = 0;      //duration of the current entry in tenths of seconds
+uint16_t       playlistLen;               //number of playlist entries
+int16_t        playlistIndex = -1;
+uint32_t       playlistEntryDur = 0;      //duration of the current entry in milliseconds
+
+static uint32_t      playlistPeriod = 0;  //sum of all entry durations (ms)
+static unsigned long playlistNextCue = 0; //millis() at which the next entry is due
+static bool          playlistPreload = false; //next entry's preset should be read ahead
 
 //values we need to keep about the parent playlist while inside sub-playlist
 //int8_t         parentPlaylistIndex = -1;
@@ -49,6 +59,8 @@ void unloadPlaylist() {
   }
   currentPlaylist = playlistIndex = -1;
   playlistLen = playlistEntryDur = playlistOptions = 0;
+  playlistPeriod = 0;
+  playlistPreload = false;
   DEBUG_PRINTLN(F("Playlist unloaded."));
 }
 
@@ -59,12 +71,12 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
   JsonArray presets = playlistObj["ps"];
   playlistLen = presets.size();
   if (playlistLen == 0) return -1;
-  if (playlistLen > 100) playlistLen = 100;
+  if (playlistLen > WLED_MAX_PLAYLIST_ENTRIES) playlistLen = WLED_MAX_PLAYLIST_ENTRIES;
 
   playlistEntries = new PlaylistEntry[playlistLen];
   if (playlistEntries == nullptr) return -1;
 
-  byte it = 0;
+  unsigned it = 0;
   for (int ps : presets) {
     if (it >= playlistLen) break;
     playlistEntries[it].preset = ps;
@@ -74,17 +86,31 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
   it = 0;
   JsonArray durations = playlistObj["dur"];
   if (durations.isNull()) {
-    playlistEntries[0].dur = playlistObj["dur"] | 100; //10 seconds as fallback
+    playlistEntries[0].dur = 100 * (playlistObj["dur"] | 100); //10 seconds as fallback
     it = 1;
   } else {
     for (int dur : durations) {
       if (it >= playlistLen) break;
-      playlistEntries[it].dur = (dur > 1) ? dur : 100;
+      playlistEntries[it].dur = 100 * ((dur > 1) ? dur : 100);
       it++;
     }
   }
   for (int i = it; i < playlistLen; i++) playlistEntries[i].dur = playlistEntries[it -1].dur;
 
+  // optional sub-second durations (in ms), take precedence over "dur"
+  JsonVariant ms = playlistObj["ms"];
+  if (ms.is<JsonArray>()) {
+    it = 0;
+    for (uint32_t dur : ms.as<JsonArray>()) {
+      if (it >= playlistLen) break;
+      if (dur) playlistEntries[it].dur = dur;
+      it++;
+    }
+  } else if (ms.as<uint32_t>() > 0) {
+    for (int i = 0; i < playlistLen; i++) playlistEntries[i].dur = ms.as<uint32_t>();
+  }
+  for (int i = 0; i < playlistLen; i++) playlistPeriod += playlistEntries[i].dur;
+
   it = 0;
   JsonArray tr = playlistObj[F("transition")];
   if (tr.isNull()) {
@@ -112,7 +138,8 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
   if (playlistEndPreset == 255 && currentPreset > 0) playlistEndPreset = currentPreset;
   if (playlistEndPreset > 250) playlistEndPreset = 0;
   shuffle = shuffle || playlistObj["r"];
-  if (shuffle) playlistOptions |= PL_OPTION_SHUFFLE;
+  if (playlistObj[F("sync")]) playlistOptions |= PL_OPTION_SYNC; // all nodes need the same order, no shuffle
+  else if (shuffle)           playlistOptions |= PL_OPTION_SHUFFLE;
 
   currentPlaylist = presetId;
   DEBUG_PRINTLN(F("Playlist loaded."));
@@ -121,33 +148,63 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
 
 
 void handlePlaylist() {
-  static unsigned long presetCycledTime = 0;
   // if fileDoc is not null JSON buffer is in use so just quit
   if (currentPlaylist < 0 || playlistEntries == nullptr || fileDoc != nullptr) return;
 
-  if (millis() - presetCycledTime > (100*playlistEntryDur)) {
-    presetCycledTime = millis();
-    if (bri == 0 || nightlightActive) return;
+  unsigned long now = millis();
+  unsigned lead = strip.getFrameTime()/2; // cue fires on the frame closest to its due time
+
+  if (playlistIndex >= 0 && (long)(playlistNextCue - now) > (long)lead) {
+    // current entry has been applied by now (handlePresets() runs after us), read next one ahead of its cue
+    if (playlistPreload && preloadPreset(playlistEntries[(playlistIndex + 1) % playlistLen].preset)) {
+      playlistPreload = false; // otherwise busy, retry on next loop
+    }
+    return;
+  }
 
+  if (bri == 0 || nightlightActive) {
+    playlistNextCue = now + playlistEntryDur;
+    return;
+  }
+
+  int16_t  prevIndex = playlistIndex;
+  uint32_t pos = 0, start = 0;
+  bool     synced = (playlistOptions & PL_OPTION_SYNC) && playlistPeriod;
+  if (synced) {
+    // position within playlist from wall clock, identical on all synced nodes
+    Toki::Time t = toki.getTime();
+    pos = (((uint64_t)t.sec) * 1000 + t.ms + lead) % playlistPeriod;
+    playlistIndex = 0;
+    while (pos >= start + playlistEntries[playlistIndex].dur) start += playlistEntries[playlistIndex++].dur;
+  } else {
     ++playlistIndex %= playlistLen; // -1 at 1st run (limit to playlistLen)
+  }
 
-    // playlist roll-over
-    if (!playlistIndex) {
-      if (playlistRepeat == 1) { //stop if all repetitions are done
-        unloadPlaylist();
-        if (playlistEndPreset) applyPreset(playlistEndPreset);
-        return;
-      }
-      if (playlistRepeat > 1) playlistRepeat--; // decrease repeat count on each index reset if not an endless playlist
-      // playlistRepeat == 0: endless loop
-      if (playlistOptions & PL_OPTION_SHUFFLE) shufflePlaylist(); // shuffle playlist and start over
+  // playlist roll-over
+  if (prevIndex < 0 || playlistIndex <= prevIndex) {
+    if (playlistRepeat == 1) { //stop if all repetitions are done
+      unloadPlaylist();
+      if (playlistEndPreset) applyPreset(playlistEndPreset);
+      return;
     }
+    if (playlistRepeat > 1) playlistRepeat--; // decrease repeat count on each index reset if not an endless playlist
+    // playlistRepeat == 0: endless loop
+    if (playlistOptions & PL_OPTION_SHUFFLE) shufflePlaylist(); // shuffle playlist and start over
+  }
 
-    jsonTransitionOnce = true;
-    strip.setTransition(fadeTransition ? playlistEntries[playlistIndex].tr * 100 : 0);
-    playlistEntryDur = playlistEntries[playlistIndex].dur;
-    applyPreset(playlistEntries[playlistIndex].preset);
+  playlistEntryDur = playlistEntries[playlistIndex].dur;
+  if (synced) {
+    playlistNextCue = now + lead + (start + playlistEntryDur - pos);
+  } else {
+    // next cue is relative to this cue's due time; restart timeline if we fell behind by more than an entry
+    if (prevIndex < 0 || (long)(now - playlistNextCue) > (long)playlistEntryDur) playlistNextCue = now;
+    playlistNextCue += playlistEntryDur;
   }
+  playlistPreload = true;
+
+  jsonTransitionOnce = true;
+  strip.setTransition(fadeTransition ? playlistEntries[playlistIndex].tr * 100 : 0);
+  applyPreset(playlistEntries[playlistIndex].preset);
 }
 
 
@@ -159,9 +216,16 @@ void serializePlaylist(JsonObject sObj) {
   playlist[F("repeat")] = (playlistIndex < 0 && playlistRepeat > 0) ? playlistRepeat - 1 : playlistRepeat; // remove added repetition count (if not yet running)
   playlist["end"] = playlistEndPreset;
   playlist["r"] = playlistOptions & PL_OPTION_SHUFFLE;
+  if (playlistOptions & PL_OPTION_SYNC) playlist[F("sync")] = true;
+  bool subSecond = false;
   for (int i=0; i<playlistLen; i++) {
     ps.add(playlistEntries[i].preset);
-    dur.add(playlistEntries[i].dur);
+    dur.add((playlistEntries[i].dur + 50) / 100);
     transition.add(playlistEntries[i].tr);
+    if (playlistEntries[i].dur % 100) subSecond = true;
+  }
+  if (subSecond) {
+    JsonArray ms = playlist.createNestedArray("ms");
+    for (int i=0; i<playlistLen; i++) ms.add(playlistEntries[i].dur);
   }
 }
@@ -16,10 +16,121 @@ static char quickLoad[9];
 static char saveName[33];
 static bool includeBri = true, segBounds = true, selectedOnly = false, playlistSave = false;;
 
+// recently used presets kept in RAM as MessagePack (compact, parses without file access)
+typedef struct PresetCacheEntry {
+  byte    *data;
+  uint16_t len;
+  byte     preset;          // 0 = empty slot
+  unsigned long lastUse;
+} pce;
+
+static PresetCacheEntry presetCache[WLED_PRESET_CACHE_SIZE] = {};
+static unsigned long presetCacheTime = 0;  // presetsModifiedTime when cache was filled (file may be replaced via /upload)
+static uint32_t presetCacheHits = 0, presetCacheMisses = 0;
+
 static const char *getFileName(bool persist = true) {
   return persist ? "/presets.json" : "/tmp.json";
 }
 
+void invalidatePresetCache(byte index) {
+  for (unsigned i = 0; i < WLED_PRESET_CACHE_SIZE; i++) {
+    if (presetCache[i].preset == 0 || (index && presetCache[i].preset != index)) continue;
+    free(presetCache[i].data);
+    presetCache[i].data   = nullptr;
+    presetCache[i].len    = 0;
+    presetCache[i].preset = 0;
+  }
+}
+
+// presets.json (or any other file) was replaced or edited outside of preset saving (upload, file editor)
+// modification time is kept increasing so that the cache is dropped even if file changes twice within a second
+void presetsFileChanged() {
+  unsigned long t = toki.second();
+  presetsModifiedTime = (t > presetsModifiedTime) ? t : presetsModifiedTime + 1;
+}
+
+// presets.json was written by us: only the written preset leaves the cache (unless file was also changed otherwise)
+static void presetWritten(byte index) {
+  bool current = (presetCacheTime == presetsModifiedTime);
+  presetsFileChanged();
+  invalidatePresetCache(index);
+  if (current) presetCacheTime = presetsModifiedTime;
+}
+
+static PresetCacheEntry *getCachedPreset(byte index) {
+  if (presetCacheTime != presetsModifiedTime) {
+    invalidatePresetCache();
+    presetCacheTime = presetsModifiedTime;
+  }
+  for (unsigned i = 0; i < WLED_PRESET_CACHE_SIZE; i++) {
+    if (presetCache[i].preset == index) {
+      presetCache[i].lastUse = millis();
+      return &presetCache[i];
+    }
+  }
+  return nullptr;
+}
+
+// store preset (as just read from presets.json) in least recently used cache slot
+static void cachePreset(byte index, JsonDocument *pDoc) {
+  if (index == 0 || index > 250 || WLED_PRESET_CACHE_SIZE == 0) return;
+  size_t len = measureMsgPack(*pDoc);
+  if (len > UINT16_MAX || len > WLED_PRESET_CACHE_BYTES) return;
+  unsigned slot;
+  for (;;) { // use empty or least recently used slot, evict presets until new one fits into WLED_PRESET_CACHE_BYTES
+    size_t used = 0;
+    int empty = -1, lru = -1;
+    for (unsigned i = 0; i < WLED_PRESET_CACHE_SIZE; i++) {
+      if (presetCache[i].preset == 0) { if (empty < 0) empty = i; continue; }
+      used += presetCache[i].len;
+      if (lru < 0 || presetCache[i].lastUse < presetCache[lru].lastUse) lru = i;
+    }
+    if (empty >= 0 && used + len <= WLED_PRESET_CACHE_BYTES) { slot = empty; break; }
+    if (used - presetCache[lru].len + len <= WLED_PRESET_CACHE_BYTES) { slot = lru; break; } // lru >= 0 as used > 0 or no empty slot
+    invalidatePresetCache(presetCache[lru].preset);
+  }
+  free(presetCache[slot].data);
+  #if defined(ARDUINO_ARCH_ESP32) && defined(BOARD_HAS_PSRAM) && defined(WLED_USE_PSRAM)
+  if (psramFound())
+    presetCache[slot].data = (byte*) ps_malloc(len);
+  else
+  #endif
+    presetCache[slot].data = (byte*) malloc(len);
+  if (presetCache[slot].data == nullptr) {
+    presetCache[slot].preset = 0;
+    return;
+  }
+  presetCache[slot].len     = serializeMsgPack(*pDoc, presetCache[slot].data, len);
+  presetCache[slot].preset  = index;
+  presetCache[slot].lastUse = millis();
+  presetCacheTime = presetsModifiedTime;
+}
+
+// read preset ahead of time (e.g. next playlist entry) so that a following applyPreset(index) is served from cache
+// must not be called while JSON buffer is in use, returns false if busy (caller should retry later)
+bool preloadPreset(byte index) {
+  if (index == 0 || index > 250) return false;
+  if (getCachedPreset(index)) return true;
+  if (fileDoc != nullptr || presetToApply || presetToSave) return false; // busy, try later
+
+  if (!requestJSONBufferLock(22)) return false;
+  if (readObjectFromFileUsingId(getFileName(), index, fileDoc)) {
+    cachePreset(index, fileDoc);
+    DEBUG_PRINT(F("Preloaded preset: ")); DEBUG_PRINTLN(index);
+  }
+  releaseJSONBufferLock();
+  return true; // done, even if preset does not exist or is too large to cache (no point in retrying)
+}
+
+void serializePresetCacheInfo(JsonObject info) {
+  unsigned n = 0, size = 0;
+  for (unsigned i = 0; i < WLED_PRESET_CACHE_SIZE; i++) if (presetCache[i].preset) { n++; size += presetCache[i].len; }
+  info["n"]   = n;
+  info["s"]   = size;
+  info[F("hit")]  = presetCacheHits;
+  info[F("miss")] = presetCacheMisses;
+}
+
 static void doSaveState() {
   bool persist = (presetToSave < 251);
   const char *filename = getFileName(persist);
@@ -67,7 +178,9 @@ static void doSaveState() {
   #endif
   writeObjectToFileUsingId(filename, presetToSave, fileDoc);
 
-  if (persist) presetsModifiedTime = toki.second(); //unix time
+  if (persist) {
+    presetWritten(presetToSave);
+  }
   releaseJSONBufferLock();
   updateFSInfo();
 
@@ -161,7 +274,18 @@ void handlePresets()
   } else
   #endif
   {
-  errorFlag = readObjectFromFileUsingId(filename, tmpPreset, fileDoc) ? ERR_NONE : ERR_FS_PLOAD;
+    PresetCacheEntry *cached = (tmpPreset < 255) ? getCachedPreset(tmpPreset) : nullptr;
+    if (cached) {
+      deserializeMsgPack(*fileDoc, (const char*)cached->data, cached->len); // copies strings, cache may change while state is applied
+      errorFlag = ERR_NONE;
+      presetCacheHits++;
+    } else {
+      errorFlag = readObjectFromFileUsingId(filename, tmpPreset, fileDoc) ? ERR_NONE : ERR_FS_PLOAD;
+      if (tmpPreset < 255) {
+        presetCacheMisses++;
+        if (!errorFlag) cachePreset(tmpPreset, fileDoc);
+      }
+    }
   }
   fdo = fileDoc->as<JsonObject>();
 
@@ -231,7 +355,7 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
       if (sObj["n"].isNull()) sObj["n"] = saveName;
       initPresetsFile(); // just in case if someone deleted presets.json using /edit
       writeObjectToFileUsingId(getFileName(index<255), index, fileDoc);
-      presetsModifiedTime = toki.second(); //unix time
+      presetWritten(index);
       updateFSInfo();
     } else {
       // store playlist
@@ -245,6 +369,6 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
 void deletePreset(byte index) {
   StaticJsonDocument<24> empty;
   writeObjectToFileUsingId(getFileName(), index, &empty);
-  presetsModifiedTime = toki.second(); //unix time
+  presetWritten(index);
   updateFSInfo();
 }
\ No newline at end of file
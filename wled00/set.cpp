@@ -246,6 +246,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       gammaCorrectBri = false;
       gammaCorrectCol = false;
     }
+    strip.invalidateCustomPaletteCache(); // custom palettes are gamma corrected when loaded
 
     fadeTransition = request->hasArg(F("TF"));
     modeBlending = request->hasArg(F("EB"));
@@ -458,6 +459,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
         timerDayEnd[i] = request->arg(k).toInt();
       }
     }
+    invalidateTimers();
   }
 
   //SECURITY
@@ -536,6 +538,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       t = request->arg(argname).toInt();
       DMXFixtureMap[i] = t;
     }
+    invalidateDMXMap();
   }
   #endif
 
@@ -31,7 +31,7 @@ bool dmxStarted = false;
 int sendPin = 2;		//default on ESP8266
 
 //DMX value array and size. Entry 0 will hold startbyte
-uint8_t dmxDataStore[dmxMaxChannel] = {};
+uint8_t dmxDataStore[dmxMaxChannel+1] = {}; // channels are 1 based
 int channelSize;
 
 
@@ -35,7 +35,7 @@ static const int rxPin = -1;       // disable the receiving pin because it is no
 static const int txPin = 2;        // transmit DMX data over this pin (default is pin 2)
 
 //DMX value array and size. Entry 0 will hold startbyte
-static uint8_t dmxData[dmxMaxChannel] = { 0 };
+static uint8_t dmxData[dmxMaxChannel+1] = { 0 }; // channels are 1 based
 static int chanSize = 0;
 #if !defined(DMX_SEND_ONLY)
 static int currentChannel = 0;
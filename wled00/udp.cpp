@@ -4,7 +4,7 @@
  * UDP sync notifier / Realtime / Hyperion / TPM2.NET
  */
 
-#define UDP_SEG_SIZE 36
+#define UDP_SEG_SIZE SEG_STATE_SIZE
 #define SEG_OFFSET (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE))
 #define WLEDPACKETSIZE (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE)+0)
 #define UDP_IN_MAXSIZE 1472
@@ -96,42 +96,9 @@ void notify(byte callMode, bool followUp)
     Segment &selseg = strip.getSegment(i);
     if (!selseg.isActive()) continue;
     uint16_t ofs = 41 + s*UDP_SEG_SIZE; //start of segment offset byte
+    selseg.saveState(&udpOut[ofs]);
     udpOut[0 +ofs] = s;
-    udpOut[1 +ofs] = selseg.start >> 8;
-    udpOut[2 +ofs] = selseg.start & 0xFF;
-    udpOut[3 +ofs] = selseg.stop >> 8;
-    udpOut[4 +ofs] = selseg.stop & 0xFF;
-    udpOut[5 +ofs] = selseg.grouping;
-    udpOut[6 +ofs] = selseg.spacing;
-    udpOut[7 +ofs] = selseg.offset >> 8;
-    udpOut[8 +ofs] = selseg.offset & 0xFF;
-    udpOut[9 +ofs] = selseg.options & 0x8F; //only take into account selected, mirrored, on, reversed, reverse_y (for 2D); ignore freeze, reset, transitional
-    udpOut[10+ofs] = selseg.opacity;
-    udpOut[11+ofs] = selseg.mode;
-    udpOut[12+ofs] = selseg.speed;
-    udpOut[13+ofs] = selseg.intensity;
-    udpOut[14+ofs] = selseg.palette;
-    udpOut[15+ofs] = R(selseg.colors[0]);
-    udpOut[16+ofs] = G(selseg.colors[0]);
-    udpOut[17+ofs] = B(selseg.colors[0]);
-    udpOut[18+ofs] = W(selseg.colors[0]);
-    udpOut[19+ofs] = R(selseg.colors[1]);
-    udpOut[20+ofs] = G(selseg.colors[1]);
-    udpOut[21+ofs] = B(selseg.colors[1]);
-    udpOut[22+ofs] = W(selseg.colors[1]);
-    udpOut[23+ofs] = R(selseg.colors[2]);
-    udpOut[24+ofs] = G(selseg.colors[2]);
-    udpOut[25+ofs] = B(selseg.colors[2]);
-    udpOut[26+ofs] = W(selseg.colors[2]);
-    udpOut[27+ofs] = selseg.cct;
-    udpOut[28+ofs] = (selseg.options>>8) & 0xFF; //mirror_y, transpose, 2D mapping & sound
-    udpOut[29+ofs] = selseg.custom1;
-    udpOut[30+ofs] = selseg.custom2;
-    udpOut[31+ofs] = selseg.custom3 | (selseg.check1<<5) | (selseg.check2<<6) | (selseg.check3<<7);
-    udpOut[32+ofs] = selseg.startY >> 8;
-    udpOut[33+ofs] = selseg.startY & 0xFF;
-    udpOut[34+ofs] = selseg.stopY >> 8;
-    udpOut[35+ofs] = selseg.stopY & 0xFF;
+    udpOut[9 +ofs] &= 0x8F; //only take into account selected, mirrored, on, reversed, reverse_y (for 2D); ignore freeze, reset, transitional
     ++s;
   }
 
@@ -151,6 +118,7 @@ void notify(byte callMode, bool followUp)
 
 void realtimeLock(uint32_t timeoutMs, byte md)
 {
+  updateRealtimeSink();
   if (!realtimeMode && !realtimeOverride) {
     uint16_t stop, start;
     if (useMainSegmentOnly) {
@@ -250,13 +218,7 @@ void handleNotifications()
       rgbUdp.read(lbuf, packetSize);
       realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
-      uint16_t id = 0;
-      uint16_t totalLen = strip.getLengthTotal();
-      for (size_t i = 0; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, MIN(packetSize/3, (size_t)strip.getLengthTotal()), lbuf);
       if (!(realtimeMode && useMainSegmentOnly)) strip.show();
       return;
     }
@@ -366,49 +328,19 @@ void handleNotifications()
           Segment& selseg = strip.getSegment(id);
           if (!selseg.isActive() || !selseg.isSelected()) continue; //do not apply to non selected segments
 
-          uint16_t startY = 0, start  = (udpIn[1+ofs] << 8 | udpIn[2+ofs]);
-          uint16_t stopY  = 1, stop   = (udpIn[3+ofs] << 8 | udpIn[4+ofs]);
-          uint16_t offset = (udpIn[7+ofs] << 8 | udpIn[8+ofs]);
-          if (!receiveSegmentOptions) {
-            selseg.setUp(start, stop, selseg.grouping, selseg.spacing, offset, startY, stopY);
-            continue;
-          }
-          //for (size_t j = 1; j<4; j++) selseg.setOption(j, (udpIn[9 +ofs] >> j) & 0x01); //only take into account mirrored, on, reversed; ignore selected
-          selseg.options = (selseg.options & 0x0071U) | (udpIn[9 +ofs] & 0x0E); // ignore selected, freeze, reset & transitional
-          selseg.setOpacity(udpIn[10+ofs]);
-          if (applyEffects) {
-            strip.setMode(id,  udpIn[11+ofs]);
-            selseg.speed     = udpIn[12+ofs];
-            selseg.intensity = udpIn[13+ofs];
-            selseg.palette   = udpIn[14+ofs];
-          }
-          if (receiveNotificationColor || !someSel) {
-            selseg.setColor(0, RGBW32(udpIn[15+ofs],udpIn[16+ofs],udpIn[17+ofs],udpIn[18+ofs]));
-            selseg.setColor(1, RGBW32(udpIn[19+ofs],udpIn[20+ofs],udpIn[21+ofs],udpIn[22+ofs]));
-            selseg.setColor(2, RGBW32(udpIn[23+ofs],udpIn[24+ofs],udpIn[25+ofs],udpIn[26+ofs]));
-            selseg.setCCT(udpIn[27+ofs]);
-          }
-          if (version > 11) {
-            // when applying synced options ignore selected as it may be used as indicator of which segments to sync
-            // freeze, reset should never be synced
-            // LSB to MSB: select, reverse, on, mirror, freeze, reset, reverse_y, mirror_y, transpose, map1d2d (3), ssim (2), set (2)
-            selseg.options = (selseg.options & 0b0000000000110001U) | (udpIn[28+ofs]<<8) | (udpIn[9 +ofs] & 0b11001110U); // ignore selected, freeze, reset
-            if (applyEffects) {
-              selseg.custom1 = udpIn[29+ofs];
-              selseg.custom2 = udpIn[30+ofs];
-              selseg.custom3 = udpIn[31+ofs] & 0x1F;
-              selseg.check1  = (udpIn[31+ofs]>>5) & 0x1;
-              selseg.check1  = (udpIn[31+ofs]>>6) & 0x1;
-              selseg.check1  = (udpIn[31+ofs]>>7) & 0x1;
-            }
-            startY = (udpIn[32+ofs] << 8 | udpIn[33+ofs]);
-            stopY  = (udpIn[34+ofs] << 8 | udpIn[35+ofs]);
-          }
-          if (receiveSegmentBounds) {
-            selseg.setUp(start, stop, udpIn[5+ofs], udpIn[6+ofs], offset, startY, stopY);
-          } else {
-            selseg.setUp(selseg.start, selseg.stop, udpIn[5+ofs], udpIn[6+ofs], selseg.offset, selseg.startY, selseg.stopY);
+          // older senders use shorter segment records, missing fields keep current values
+          byte state[SEG_STATE_SIZE];
+          selseg.saveState(state);
+          if (udpIn[40] > 1) memcpy(state + 1, &udpIn[1+ofs], min((int)udpIn[40], SEG_STATE_SIZE) - 1);
+          // when applying synced options ignore selected as it may be used as indicator of which segments to sync
+          // freeze, reset should never be synced
+          uint8_t what = receiveSegmentBounds ? SEG_DIFFERS_BOUNDS : 0;
+          if (receiveSegmentOptions) {
+            what |= SEG_DIFFERS_OPT | SEG_DIFFERS_BRI | SEG_DIFFERS_GSO;
+            if (applyEffects)                         what |= SEG_DIFFERS_FX;
+            if (receiveNotificationColor || !someSel) what |= SEG_DIFFERS_COL;
           }
+          selseg.applyState(state, what);
         }
         stateChanged = true;
       }
@@ -491,15 +423,7 @@ void handleNotifications()
 
     uint16_t id = (tpmPayloadFrameSize/3)*(packetNum-1); //start LED
     uint16_t totalLen = strip.getLengthTotal();
-    for (size_t i = 6; i < tpmPayloadFrameSize + 4U; i += 3)
-    {
-      if (id < totalLen)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-      else break;
-    }
+    if (id < totalLen && tpmPayloadFrameSize > 2) setRealtimePixels(id, MIN(tpmPayloadFrameSize/3, totalLen - id), udpIn + 6);
     if (tpmPacketCount == numPackets) //reset packet count and show if all packets were received
     {
       tpmPacketCount = 0;
@@ -533,40 +457,18 @@ void handleNotifications()
       }
     } else if (udpIn[0] == 2) //drgb
     {
-      uint16_t id = 0;
-      for (size_t i = 2; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-
-        id++; if (id >= totalLen) break;
-      }
-    } else if ((udpIn[0] == 3) && (packetSize > 5)) //drgbw - avoiding infinite "for" loop (unsigned underflow)
+      setRealtimePixels(0, MIN((packetSize-2)/3, (size_t)totalLen), udpIn + 2);
+    } else if ((udpIn[0] == 3) && (packetSize > 5)) //drgbw
     {
-      uint16_t id = 0;
-      for (size_t i = 2; i < packetSize -3; i += 4)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-
-        id++; if (id >= totalLen) break;
-      }
-    } else if (udpIn[0] == 4) //dnrgb
+      setRealtimePixels(0, MIN((packetSize-2)/4, (size_t)totalLen), udpIn + 2, 4);
+    } else if (udpIn[0] == 4 && packetSize > 4) //dnrgb
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 3)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-    } else if (udpIn[0] == 5) //dnrgbw
+      if (id < totalLen) setRealtimePixels(id, MIN((packetSize-4)/3, (size_t)(totalLen - id)), udpIn + 4);
+    } else if (udpIn[0] == 5 && packetSize > 4) //dnrgbw
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2; i += 4)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        id++;
-      }
+      if (id < totalLen) setRealtimePixels(id, MIN((packetSize-4)/4, (size_t)(totalLen - id)), udpIn + 4, 4);
     }
     strip.show();
     return;
@@ -590,22 +492,69 @@ void handleNotifications()
 }
 
 
+/*
+ * Realtime frame sink: target (offset, length, gamma, main segment or whole strip) is resolved once
+ * in realtimeLock() for each received packet/frame instead of for every pixel.
+ */
+static struct RealtimeSink {
+  int      offset;  // arlsOffset
+  uint16_t length;  // number of LEDs that can be set
+  bool     gamma;   // apply gamma correction
+  uint8_t  segId;   // main segment (useMainSegmentOnly) or 255 for whole strip; index because segments may be reallocated between frames
+} rtSink = {0, 0, false, 255};
+
+static void updateRealtimeSink()
+{
+  rtSink.offset = arlsOffset;
+  rtSink.gamma  = !arlsDisableGammaCorrection && gammaCorrectCol;
+  rtSink.length = strip.getLengthTotal();
+  rtSink.segId  = 255;
+  if (useMainSegmentOnly) {
+    rtSink.segId = strip.getMainSegmentId();
+    uint16_t len = strip.getSegment(rtSink.segId).length();
+    if (len < rtSink.length) rtSink.length = len;
+  }
+}
+
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
 {
-  uint16_t pix = i + arlsOffset;
-  if (pix < strip.getLengthTotal()) {
-    if (!arlsDisableGammaCorrection && gammaCorrectCol) {
+  int pix = i + rtSink.offset;
+  if (pix < 0 || pix >= rtSink.length) return;
+  if (rtSink.gamma) {
+    r = gamma8(r);
+    g = gamma8(g);
+    b = gamma8(b);
+    w = gamma8(w);
+  }
+  if (rtSink.segId != 255) strip.getSegment(rtSink.segId).setPixelColor(pix, RGBW32(r, g, b, w)); // bounds checked
+  else                     strip.setPixelColor(pix, RGBW32(r, g, b, w));
+}
+
+// set a span of consecutive realtime pixels from packed RGB (stride 3) or RGBW (stride 4) data
+void setRealtimePixels(uint16_t start, uint16_t count, const byte *data, uint8_t stride)
+{
+  int pix = start + rtSink.offset;
+  if (pix < 0) { // clip start
+    if (count <= -pix) return;
+    count += pix;
+    data  -= pix * stride;
+    pix    = 0;
+  }
+  if (pix >= rtSink.length) return;
+  if (count > rtSink.length - pix) count = rtSink.length - pix;
+
+  Segment *seg = rtSink.segId != 255 ? &strip.getSegment(rtSink.segId) : nullptr; // valid for this call only
+  const bool rgbw = stride > 3;
+  for (; count > 0; count--, pix++, data += stride) {
+    byte r = data[0], g = data[1], b = data[2], w = rgbw ? data[3] : 0;
+    if (rtSink.gamma) {
       r = gamma8(r);
       g = gamma8(g);
       b = gamma8(b);
       w = gamma8(w);
     }
-    if (useMainSegmentOnly) {
-      Segment &seg = strip.getMainSegment();
-      if (pix<seg.length()) seg.setPixelColor(pix, r, g, b, w);
-    } else {
-      strip.setPixelColor(pix, r, g, b, w);
-    }
+    if (seg) seg->setPixelColor(pix, RGBW32(r, g, b, w));
+    else     strip.setPixelColor(pix, RGBW32(r, g, b, w));
   }
 }
 
@@ -717,12 +666,13 @@ void sendSysInfoUDP()
 // length - the number of pixels
 // buffer - a buffer of at least length*4 bytes long
 // isRGBW - true if the buffer contains 4 components per pixel
+// start  - first pixel to send (DDP only), pixels start...start+length-1 of buffer are sent
 
 static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
 static const size_t ART_NET_HEADER_SIZE = 12;
 static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
 
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW, uint16_t start)  {
   if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
 
   WiFiUDP ddpUdp;
@@ -734,10 +684,10 @@ uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8
       size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B value
       size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
 
-      // there are 3 channels per RGB pixel
-      uint32_t channel = 0; // TODO: allow specifying the start channel
+      // there are 3 channels per RGB pixel, receiver places data at channel offset
+      uint32_t channel = start * (isRGBW? 4:3);
       // the current position in the buffer
-      size_t bufferOffset = 0;
+      size_t bufferOffset = channel;
 
       for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
         if (sequenceNumber > 15) sequenceNumber = 0;
@@ -6,7 +6,6 @@
 //Usermod Manager internals
 void UsermodManager::setup()             { for (byte i = 0; i < numMods; i++) ums[i]->setup(); }
 void UsermodManager::connected()         { for (byte i = 0; i < numMods; i++) ums[i]->connected(); }
-void UsermodManager::loop()              { for (byte i = 0; i < numMods; i++) ums[i]->loop();  }
 void UsermodManager::handleOverlayDraw() { for (byte i = 0; i < numMods; i++) ums[i]->handleOverlayDraw(); }
 void UsermodManager::appendConfigData()  { for (byte i = 0; i < numMods; i++) ums[i]->appendConfigData(); }
 bool UsermodManager::handleButton(uint8_t b) {
@@ -42,6 +41,56 @@ bool UsermodManager::onMqttMessage(char* topic, char* payload) {
 void UsermodManager::onUpdateBegin(bool init) { for (byte i = 0; i < numMods; i++) ums[i]->onUpdateBegin(init); } // notify usermods that update is to begin
 void UsermodManager::onStateChange(uint8_t mode) { for (byte i = 0; i < numMods; i++) ums[i]->onStateChange(mode); } // notify usermods that WLED state changed
 
+/*
+ * Usermod loop scheduler
+ * Usermods without loop interval are run on every main loop iteration (as before).
+ * Usermods with a loop interval are skipped until they are due. Due usermods are taken round-robin,
+ * until WLED_USERMOD_LOOP_BUDGET is used up, so slow (e.g. I2C sensor) usermods get spread across loop iterations.
+ */
+void UsermodManager::runLoop(byte i) {
+  um_stats_t &st = stats[i];
+  unsigned long start = micros();
+  ums[i]->loop();
+  uint32_t elapsed = micros() - start;
+  st.lastRun = millis();
+  if (st.runs == 0 || elapsed < st.minTime) st.minTime = elapsed;
+  if (elapsed > st.maxTime) st.maxTime = elapsed;
+  st.avgTime = (st.runs == 0) ? elapsed : (st.avgTime * 15 + elapsed) / 16; // smooth
+  if (st.runs < UINT32_MAX) st.runs++;
+}
+
+void UsermodManager::loop() {
+  for (byte i = 0; i < numMods; i++) {
+    if (ums[i]->getLoopInterval() == 0) runLoop(i);
+  }
+
+  unsigned long start = micros();
+  unsigned long now = millis();
+  byte first = nextScheduled;
+  for (byte n = 0; n < numMods; n++) {
+    byte i = (first + n) % numMods;
+    uint16_t interval = ums[i]->getLoopInterval();
+    if (interval == 0 || now - stats[i].lastRun < interval) continue; // not scheduled or not due yet
+    if (micros() - start > WLED_USERMOD_LOOP_BUDGET) break;          // budget used up, continue in next iteration
+    runLoop(i);
+    nextScheduled = (i + 1) % numMods;                                // next time start with the one after
+  }
+}
+
+// runtime statistics for /json/info
+void UsermodManager::addStatsToJsonInfo(JsonObject& obj) {
+  JsonArray arr = obj.createNestedArray(F("um"));
+  for (byte i = 0; i < numMods; i++) {
+    JsonObject um = arr.createNestedObject();
+    um["id"]       = ums[i]->getId();
+    um[F("ivl")]   = ums[i]->getLoopInterval();
+    um[F("runs")]  = stats[i].runs;
+    um[F("min")]   = stats[i].minTime;
+    um[F("avg")]   = stats[i].avgTime;
+    um[F("max")]   = stats[i].maxTime;
+  }
+}
+
 /*
  * Enables usermods to lookup another Usermod.
  */
@@ -57,6 +106,7 @@ Usermod* UsermodManager::lookup(uint16_t mod_id) {
 bool UsermodManager::add(Usermod* um)
 {
   if (numMods >= WLED_MAX_USERMODS || um == nullptr) return false;
+  memset(&stats[numMods], 0, sizeof(um_stats_t));
   ums[numMods++] = um;
   return true;
 }
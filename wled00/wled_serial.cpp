@@ -11,24 +11,142 @@ enum class AdaState {
   Header_CountHi,
   Header_CountLo,
   Header_CountCheck,
-  Data_Red,
-  Data_Green,
-  Data_Blue,
+  Data,
   TPM2_Header_Type,
   TPM2_Header_CountHi,
   TPM2_Header_CountLo,
 };
 
+// pixel data is read from serial in chunks of up to this many bytes and decoded as whole pixels
+#ifndef WLED_SERIAL_RX_CHUNK
+  #define WLED_SERIAL_RX_CHUNK 255
+#endif
+
 uint16_t currentBaud = 1152; //default baudrate 115200 (divided by 100)
 bool continuousSendLED = false;
+bool compressedSendLED = false; // continuous streaming uses delta/RLE compressed frames
 uint32_t lastUpdate = 0;
 
+/*
+ * LED readback frames are built in one buffer and written out asynchronously (only as much as fits into the
+ * serial TX buffer on each handleSerial() call), a new frame is only built once the previous one is sent.
+ *
+ * Compressed frames use TPM2 framing with packet type 0xDC: C9 DC <size hi> <size lo> <payload> 36
+ * payload: flags (bit 0: keyframe, i.e. previous frame is all black), then ops until all LEDs are covered:
+ *   0x00-0x3F: n+1 LEDs unchanged from previous frame
+ *   0x40-0x7F: n+1 LEDs of the same color, followed by R G B
+ *   0x80-0xFF: n+1 LEDs, followed by R G B of each
+ */
+#ifndef WLED_SERIAL_KEYFRAME_INTERVAL
+  #define WLED_SERIAL_KEYFRAME_INTERVAL 100 // compressed streaming sends a keyframe every N frames
+#endif
+
+static byte    *readbackBuf = nullptr;  // frame being sent
+static size_t   readbackSize = 0;       // allocated size of readbackBuf
+static size_t   readbackLen = 0;        // length of frame in readbackBuf
+static size_t   readbackPos = 0;        // bytes of frame already sent
+static byte    *readbackPrev = nullptr; // previous frame (RGB) for delta compression
+static uint16_t readbackPrevLen = 0;    // LEDs in readbackPrev
+static uint8_t  readbackFrames = 0;     // frames since last keyframe
+
+static bool canSendSerial() {
+  return !pinManager.isPinAllocated(hardwareTX) || pinManager.getPinOwner(hardwareTX) == PinOwner::DebugOut;
+}
+
+// makes sure readback buffer can hold len bytes
+static bool allocReadbackBuffer(size_t len) {
+  if (len <= readbackSize) return true;
+  byte *buf = (byte*)realloc(readbackBuf, len);
+  if (!buf) return false;
+  readbackBuf = buf;
+  readbackSize = len;
+  return true;
+}
+
+static void freeReadbackBuffers() {
+  free(readbackBuf);  readbackBuf = nullptr;  readbackSize = 0; readbackLen = readbackPos = 0;
+  free(readbackPrev); readbackPrev = nullptr; readbackPrevLen = 0;
+}
+
+// write as much of the pending frame as fits without blocking, returns true if nothing is pending
+static bool flushReadback() {
+  if (readbackPos < readbackLen) {
+    size_t n = MIN((size_t)Serial.availableForWrite(), readbackLen - readbackPos);
+    if (n) readbackPos += Serial.write(readbackBuf + readbackPos, n);
+  }
+  return readbackPos >= readbackLen;
+}
+
+static inline uint32_t readbackColor(uint16_t i) {
+  uint32_t c = strip.getPixelColor(i);
+  // add white channel to RGB channels as a simple RGBW -> RGB map
+  return RGBW32(qadd8(W(c), R(c)), qadd8(W(c), G(c)), qadd8(W(c), B(c)), 0);
+}
+
+// delta/RLE compressed frame (see above) into readbackBuf
+static void buildCompressedFrame() {
+  uint16_t used = strip.getLengthTotal();
+  // current frame (RGB) is read into the tail of readbackBuf; compressed output is written from the front and
+  // never overtakes it (only a new literal op after 128 literal LEDs adds a byte more than it consumes)
+  size_t rawOfs = 4 + 1 + used/128 + 2;
+  if (!allocReadbackBuffer(rawOfs + used*3 + 1)) return;
+  if (readbackPrevLen != used || !readbackPrev) {
+    free(readbackPrev);
+    readbackPrev = (byte*)malloc(used*3);
+    readbackPrevLen = readbackPrev ? used : 0;
+    readbackFrames = 0;
+    if (!readbackPrev) return;
+  }
+  bool keyframe = (readbackFrames == 0);
+  if (keyframe) memset(readbackPrev, 0, used*3);
+  if (++readbackFrames >= WLED_SERIAL_KEYFRAME_INTERVAL) readbackFrames = 0;
+
+  byte *raw = readbackBuf + rawOfs;
+  for (uint16_t i = 0; i < used; i++) {
+    uint32_t c = readbackColor(i);
+    raw[i*3] = R(c); raw[i*3+1] = G(c); raw[i*3+2] = B(c);
+  }
+
+  byte *out = readbackBuf + 4;
+  *out++ = keyframe;
+  byte *lit = nullptr; // op byte of current literal run
+  for (unsigned i = 0; i < used; ) {
+    unsigned n = 0;
+    while (i+n < used && n < 64 && !memcmp(raw + (i+n)*3, readbackPrev + (i+n)*3, 3)) n++;
+    if (n) { // unchanged LEDs
+      *out++ = n-1;
+      lit = nullptr;
+      i += n;
+      continue;
+    }
+    byte rgb[3];
+    memcpy(rgb, raw + i*3, 3); // output may overwrite it
+    while (i+n < used && n < 64 && !memcmp(raw + (i+n)*3, rgb, 3)) n++;
+    for (unsigned j = i; j < i+n; j++) memcpy(readbackPrev + j*3, rgb, 3);
+    if (n > 1) { // LEDs of the same color
+      *out++ = 0x40 | (n-1);
+      lit = nullptr;
+    } else { // literal LED, extend current literal run if possible
+      if (!lit || *lit == 0xFF) { lit = out++; *lit = 0x7F; }
+      (*lit)++;
+    }
+    memcpy(out, rgb, 3); out += 3;
+    i += n;
+  }
+  size_t len = out - (readbackBuf + 4);
+  readbackBuf[0] = 0xC9; readbackBuf[1] = 0xDC;
+  readbackBuf[2] = highByte(len); readbackBuf[3] = lowByte(len);
+  *out++ = 0x36;
+  readbackLen = out - readbackBuf;
+  readbackPos = 0;
+}
+
 void updateBaudRate(uint32_t rate){
   uint16_t rate100 = rate/100;
   if (rate100 == currentBaud || rate100 < 96) return;
   currentBaud = rate100;
 
-  if (!pinManager.isPinAllocated(hardwareTX) || pinManager.getPinOwner(hardwareTX) == PinOwner::DebugOut){
+  if (canSendSerial()){
     Serial.print(F("Baud is now ")); Serial.println(rate);
   }
 
@@ -38,7 +156,7 @@ void updateBaudRate(uint32_t rate){
 
 // RGB LED data return as JSON array. Slow, but easy to use on the other end.
 void sendJSON(){
-  if (!pinManager.isPinAllocated(hardwareTX) || pinManager.getPinOwner(hardwareTX) == PinOwner::DebugOut) {
+  if (canSendSerial()) {
     uint16_t used = strip.getLengthTotal();
     Serial.write('[');
     for (uint16_t i=0; i<used; i++) {
@@ -51,20 +169,23 @@ void sendJSON(){
 
 // RGB LED data returned as bytes in TPM2 format. Faster, and slightly less easy to use on the other end.
 void sendBytes(){
-  if (!pinManager.isPinAllocated(hardwareTX) || pinManager.getPinOwner(hardwareTX) == PinOwner::DebugOut) {
-    Serial.write(0xC9); Serial.write(0xDA);
-    uint16_t used = strip.getLengthTotal();
-    uint16_t len = used*3;
-    Serial.write(highByte(len));
-    Serial.write(lowByte(len));
-    for (uint16_t i=0; i < used; i++) {
-      uint32_t c = strip.getPixelColor(i);
-      Serial.write(qadd8(W(c), R(c))); //R, add white channel to RGB channels as a simple RGBW -> RGB map
-      Serial.write(qadd8(W(c), G(c))); //G
-      Serial.write(qadd8(W(c), B(c))); //B
-    }
-    Serial.write(0x36); Serial.write('\n');
+  if (!canSendSerial()) return;
+  while (!flushReadback()) yield(); // finish previous frame first
+  uint16_t used = strip.getLengthTotal();
+  uint16_t len = used*3;
+  if (!allocReadbackBuffer(len + 6)) return;
+  byte *out = readbackBuf;
+  *out++ = 0xC9; *out++ = 0xDA;
+  *out++ = highByte(len);
+  *out++ = lowByte(len);
+  for (uint16_t i=0; i < used; i++) {
+    uint32_t c = readbackColor(i);
+    *out++ = R(c); *out++ = G(c); *out++ = B(c);
   }
+  *out++ = 0x36; *out++ = '\n';
+  readbackLen = out - readbackBuf;
+  readbackPos = 0;
+  flushReadback();
 }
 
 void handleSerial()
@@ -74,14 +195,36 @@ void handleSerial()
 
   #ifdef WLED_ENABLE_ADALIGHT
   static auto state = AdaState::Header_A;
-  static uint16_t count = 0;
   static uint16_t pixel = 0;
+  static uint32_t dataLeft = 0;     // pixel data bytes of current frame not yet read
+  static uint8_t  carry = 0;        // bytes of an incomplete pixel at the start of rxBuf
   static byte check = 0x00;
-  static byte red   = 0x00;
-  static byte green = 0x00;
+  static byte rxBuf[WLED_SERIAL_RX_CHUNK+2];
 
   while (Serial.available() > 0)
   {
+    if (state == AdaState::Data) {
+      // pixel data: read as much as is available and decode whole pixels at once
+      size_t n = MIN((size_t)Serial.available(), MIN((size_t)WLED_SERIAL_RX_CHUNK, dataLeft));
+      n = Serial.readBytes(rxBuf + carry, n);
+      if (n == 0) break;
+      dataLeft -= n;
+      size_t avail  = carry + n;
+      size_t pixels = avail / 3;
+      if (!realtimeOverride && pixels) setRealtimePixels(pixel, pixels, rxBuf);
+      pixel += pixels;
+      carry = avail - pixels*3;
+      if (carry) memmove(rxBuf, rxBuf + pixels*3, carry);
+      continuousSendLED = false; // all other received bytes will disable Continuous Serial Streaming
+      if (dataLeft == 0) {
+        carry = 0; // drop incomplete pixel (TPM2 payload not a multiple of 3)
+        realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
+        if (!realtimeOverride) strip.show();
+        state = AdaState::Header_A;
+      }
+      continue;
+    }
+
     yield();
     byte next = Serial.peek();
     switch (state) {
@@ -109,7 +252,8 @@ void handleSerial()
         } else if (next == 'L') {sendBytes(); // Send LED data as TPM2 Data Packet
 
         } else if (next == 'o') {continuousSendLED = false; // Disable Continuous Serial Streaming
-        } else if (next == 'O') {continuousSendLED = true; // Enable Continuous Serial Streaming
+        } else if (next == 'O') {continuousSendLED = true; compressedSendLED = false; // Enable Continuous Serial Streaming
+        } else if (next == 'C') {continuousSendLED = true; compressedSendLED = true; readbackFrames = 0; // Enable compressed Continuous Serial Streaming
 
         } else if (next == '{') { //JSON API
           bool verboseResponse = false;
@@ -144,19 +288,24 @@ void handleSerial()
         else             state = AdaState::Header_A;
         break;
       case AdaState::Header_CountHi:
-        pixel = 0;
-        count = next * 0x100;
+        dataLeft = next * 0x100;
         check = next;
         state = AdaState::Header_CountLo;
         break;
       case AdaState::Header_CountLo:
-        count += next + 1;
+        dataLeft = (dataLeft + next + 1) * 3; // LED count - 1, 3 bytes per LED
         check = check ^ next ^ 0x55;
         state = AdaState::Header_CountCheck;
         break;
       case AdaState::Header_CountCheck:
-        if (check == next) state = AdaState::Data_Red;
-        else               state = AdaState::Header_A;
+        pixel = 0;
+        carry = 0;
+        if (check == next) {
+          realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT); // enter realtime mode before setting pixels
+          state = AdaState::Data;
+        } else {
+          state = AdaState::Header_A;
+        }
         break;
       case AdaState::TPM2_Header_Type:
         state = AdaState::Header_A; //(unsupported) TPM2 command or invalid type
@@ -164,37 +313,26 @@ void handleSerial()
         else if (next == 0xAA) Serial.write(0xAC); //TPM2 ping
         break;
       case AdaState::TPM2_Header_CountHi:
-        pixel = 0;
-        count = (next * 0x100) /3;
+        dataLeft = next * 0x100; // payload size in bytes
         state = AdaState::TPM2_Header_CountLo;
         break;
       case AdaState::TPM2_Header_CountLo:
-        count += next /3;
-        state = AdaState::Data_Red;
-        break;
-      case AdaState::Data_Red:
-        red   = next;
-        state = AdaState::Data_Green;
-        break;
-      case AdaState::Data_Green:
-        green = next;
-        state = AdaState::Data_Blue;
-        break;
-      case AdaState::Data_Blue:
-        byte blue  = next;
-        if (!realtimeOverride) setRealtimePixel(pixel++, red, green, blue, 0);
-        if (--count > 0) state = AdaState::Data_Red;
-        else {
-          realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
-
-          if (!realtimeOverride) strip.show();
-          state = AdaState::Header_A;
+        dataLeft += next;
+        pixel = 0;
+        carry = 0;
+        state = AdaState::Header_A;
+        if (dataLeft) {
+          realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT); // enter realtime mode before setting pixels
+          state = AdaState::Data;
         }
         break;
+      default:
+        state = AdaState::Header_A;
+        break;
     }
 
     // All other received bytes will disable Continuous Serial Streaming
-    if (continuousSendLED && next != 'O'){
+    if (continuousSendLED && next != 'O' && next != 'C'){
       continuousSendLED = false;
       }
 
@@ -202,9 +340,17 @@ void handleSerial()
   }
   #endif
 
-  // If Continuous Serial Streaming is enabled, send new LED data as bytes
-  if (continuousSendLED && (lastUpdate != strip.getLastShow())){
-    sendBytes();
+  // If Continuous Serial Streaming is enabled, send new LED data as bytes (skip frames while previous one is still being sent)
+  bool idle = flushReadback();
+  if (continuousSendLED && idle && (lastUpdate != strip.getLastShow()) && canSendSerial()){
+    if (compressedSendLED) {
+      buildCompressedFrame();
+      flushReadback();
+    } else {
+      sendBytes();
+    }
     lastUpdate = strip.getLastShow();
+  } else if (!continuousSendLED && idle && readbackSize) {
+    freeReadbackBuffers();
   }
 }
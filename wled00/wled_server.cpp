@@ -52,7 +52,7 @@ void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t
     request->_tempFile = WLED_FS.open(finalname, "w");
     DEBUG_PRINT(F("Uploading "));
     DEBUG_PRINTLN(finalname);
-    if (finalname.equals("/presets.json")) presetsModifiedTime = toki.second();
+    if (finalname.equals("/presets.json")) presetsFileChanged();
   }
   if (len) {
     request->_tempFile.write(data,len);
@@ -79,6 +79,11 @@ void createEditHandler(bool enable) {
       #else
       editHandler = &server.addHandler(new SPIFFSEditor("","",WLED_FS));//http_username,http_password));
       #endif
+      // files written or deleted by the editor may include presets.json, drop preset cache once request is done
+      editHandler->setFilter([](AsyncWebServerRequest *request){
+        if (request->method() != HTTP_GET && request->url().startsWith(F("/edit"))) request->onDisconnect([](){ presetsFileChanged(); });
+        return true;
+      });
     #else
       editHandler = &server.on("/edit", HTTP_GET, [](AsyncWebServerRequest *request){
         serveMessage(request, 501, "Not implemented", F("The FS editor is disabled in this build."), 254);